@@ -0,0 +1,174 @@
+// Проверка, что тик безголового уровня не выделяет память:
+//   allocbench [файл уровня] [--ticks N] [--warmup N] [--jobs] [--ghosts N]
+// Глобальные operator new/delete подменены счётчиком. После разогрева
+// (пулы и векторы уровня набирают ёмкость) считаются выделения за N тиков;
+// код возврата 1, если они были. --jobs - ИИ призраков на JobSystem.
+// --ghosts - нагрузочная карта: она повторяется вбок, пока хватает точек,
+// и часть точек становится клетками 'G', так что призраков ровно N.
+// Конец игры не обрывает замер: уровень перезапускается, и счёт тиков идёт
+// дальше; выделения перестройки уровня (новый раунд, перезапуск) считаются
+// отдельно и на код возврата не влияют
+#include "AssetManager.h"
+#include "JobSystem.h"
+#include "Level.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::atomic<uint64_t> allocationCount{0};
+
+    void* countedAlloc(size_t size) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        if (void* memory = std::malloc(size ? size : 1)) return memory;
+        throw std::bad_alloc();
+    }
+
+    // Пакман ходит по кругу, чтобы тики ели точки и сталкивались с призраками
+    const Direction kRoute[4] = {Direction::RIGHT, Direction::DOWN, Direction::LEFT, Direction::UP};
+
+    void runTicks(Level& level, uint64_t ticks, uint64_t& tick) {
+        for (uint64_t end = tick + ticks; tick < end; ++tick) {
+            if (tick % 90 == 0) level.getPacman()->setNextDirection(kRoute[tick / 90 % 4]);
+            level.tick();
+        }
+    }
+
+    // Карта с ghosts призраками (см. --ghosts); false - не хватает клеток
+    bool makeStressMap(const std::string& text, size_t ghosts, std::string& out) {
+        std::vector<std::string> rows;
+        std::istringstream lines(text);
+        for (std::string row; std::getline(lines, row);) {
+            if (!row.empty() && row.back() == '\r') row.pop_back();
+            rows.push_back(row);
+        }
+        size_t width = 0, dots = 0, spawns = 0;
+        for (const auto& row : rows) {
+            width = std::max(width, row.size());
+            for (char c : row) {
+                if (c == '.') dots++;
+                if (c == 'G') spawns++;
+            }
+        }
+        if (ghosts <= spawns) {
+            out = text;
+            return ghosts == spawns;
+        }
+        // Копии карты ставятся вбок: тоннели соединяют их, Пакман только в первой
+        const size_t copies = dots == 0 ? 0 : (ghosts - spawns + dots - 1) / dots;
+        const size_t extra = ghosts - spawns * copies;
+        if (copies == 0 || ghosts < spawns * copies || copies * dots < extra) return false;
+        for (auto& row : rows) {
+            row.resize(width, ' ');
+            std::string copy = row;
+            for (char& c : copy) {
+                if (c == 'P') c = '.';
+            }
+            for (size_t i = 1; i < copies; ++i) row += copy;
+        }
+
+        // Новые призраки - равномерно по точкам всех копий
+        const size_t totalDots = copies * dots;
+        size_t dot = 0, placed = 0;
+        for (auto& row : rows) {
+            for (char& c : row) {
+                if (c != '.') continue;
+                if (placed < extra && dot * extra / totalDots >= placed) {
+                    c = 'G';
+                    placed++;
+                }
+                dot++;
+            }
+        }
+        out.clear();
+        for (const auto& row : rows) out += row + '\n';
+        return true;
+    }
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+
+int main(int argc, char* argv[]) {
+    std::string levelPath = "levels/level1.txt";
+    uint64_t ticks = 36000;
+    uint64_t warmup = 600;
+    bool useJobs = false;
+    size_t ghosts = 0;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) ticks = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) warmup = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--jobs") == 0) useJobs = true;
+        else if (std::strcmp(argv[i], "--ghosts") == 0 && hasValue) ghosts = std::strtoull(argv[++i], nullptr, 10);
+        else if (argv[i][0] != '-') levelPath = argv[i];
+        else std::cerr << "Unknown option: " << argv[i] << std::endl;
+    }
+
+    AssetManager assets(nullptr);
+    JobSystem jobs;
+    Level level(nullptr, assets);
+    if (ghosts == 0) {
+        if (!level.loadFromFile(levelPath)) return 1;
+    } else {
+        std::string text, stress;
+        if (!assets.readText(levelPath, text)) {
+            std::cerr << "Error: Failed to open " << levelPath << std::endl;
+            return 1;
+        }
+        if (!makeStressMap(text, ghosts, stress)) {
+            std::cerr << "Error: cannot place " << ghosts << " ghosts on " << levelPath << std::endl;
+            return 1;
+        }
+        level.loadFromText(levelPath, stress);
+    }
+    if (useJobs) level.setJobSystem(&jobs);
+
+    uint64_t tick = 0;
+    runTicks(level, warmup, tick);
+
+    // Перестройка уровня - не тик: тик, начавший новый раунд, и перезапуск
+    // после конца игры считаются в rebuildAllocations
+    uint64_t allocations = 0;
+    uint64_t rebuildAllocations = 0;
+    int rebuilds = 0;
+    for (uint64_t measured = 0; measured < ticks;) {
+        const uint64_t before = allocationCount.load(std::memory_order_relaxed);
+        if (level.isGameOver()) {
+            level.restartLevel(false);
+            rebuildAllocations += allocationCount.load(std::memory_order_relaxed) - before;
+            rebuilds++;
+            continue;
+        }
+        const int round = level.getRound();
+        runTicks(level, 1, tick);
+        const uint64_t delta = allocationCount.load(std::memory_order_relaxed) - before;
+        if (level.getRound() != round) {
+            rebuildAllocations += delta;
+            rebuilds++;
+        } else {
+            allocations += delta;
+        }
+        measured++;
+    }
+
+    std::cout << "Level " << levelPath << ", " << level.getGhostSystem().size() << " ghosts"
+              << (useJobs ? ", AI on JobSystem" : "") << std::endl;
+    std::cout << "Ticks: " << ticks << " after " << warmup << " warm-up, allocations: " << allocations
+              << ", score: " << level.getPacman()->getScore() << std::endl;
+    if (rebuilds > 0) {
+        std::cout << "Level rebuilds (new round or restart): " << rebuilds << ", allocations: " << rebuildAllocations
+                  << std::endl;
+    }
+    return allocations == 0 ? 0 : 1;
+}
@@ -2,14 +2,44 @@
 #include "MainMenu.h"
 #include "SDL2/SDL_ttf.h"
 #include "Level.h"
+#include "JobSystem.h"
+#include "AssetManager.h"
+#include "StateStream.h"
+#include "Simulation.h"
+#include "FrameCapture.h"
+#include "FrameRenderer.h"
+#include "Replay.h"
+#include <algorithm>
+#include <csignal>
 #include <iostream>
 
+namespace {
+    // Ctrl+C в записи кадров: цикл доходит до конца тика, и запись
+    // дописывается и закрывается, а не обрывается на полуслове
+    volatile std::sig_atomic_t captureInterrupted = 0;
+
+    void onCaptureSignal(int) {
+        captureInterrupted = 1;
+    }
+}
+
 App::App() {
     std::cout << "App constructor" << std::endl;
 }
 
 App::~App() {
-    currentLevel.reset();
+    // Сначала останавливаем поток симуляции: он пишет в broadcaster
+    simulation.reset();
+    stopReplay();
+    frameRenderer.reset();
+    clearOverlay();
+    if (bigFont) TTF_CloseFont(bigFont);
+    if (smallFont) TTF_CloseFont(smallFont);
+    broadcaster.reset();
+    mainMenu.reset();
+    assets.reset();
+    simAssets.reset();
+    jobs.reset();
     
     if (renderer) {
         SDL_DestroyRenderer(renderer);
@@ -29,6 +59,7 @@ App::~App() {
 }
 
 bool App::init() {
+    launchCounter = SDL_GetPerformanceCounter();
     std::cout << "Initializing SDL..." << std::endl;
     
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
@@ -53,7 +84,7 @@ bool App::init() {
     window = SDL_CreateWindow("Pacman Game", 
                             SDL_WINDOWPOS_CENTERED,
                             SDL_WINDOWPOS_CENTERED,
-                            800, 600,
+                            kWindowWidth, kWindowHeight,
                             SDL_WINDOW_SHOWN);
     if (!window) {
         std::cerr << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
@@ -76,135 +107,388 @@ bool App::init() {
         return false;
     }
 
+    jobs = std::make_unique<JobSystem>();
+    std::cout << "Job system workers: " << jobs->getWorkerCount() << std::endl;
+
+    // Ресурсы декодируются в фоне, пока показывается меню
+    assets = std::make_unique<AssetManager>(renderer);
+    if (!assets->openPack("assets.pak")) {
+        std::cout << "assets.pak not found, loading loose asset files" << std::endl;
+    }
+    assets->buildManifest({"sprites", "fonts", "levels"});
+    assets->startLoading(*jobs);
+
+    if (!broadcastPath.empty()) {
+        broadcaster = std::make_unique<StateBroadcaster>();
+        if (broadcaster->listen(broadcastPath)) {
+            std::cout << "Broadcasting game state on " << broadcastPath << std::endl;
+        } else {
+            broadcaster.reset();
+        }
+    }
+
     std::cout << "Initializing main menu..." << std::endl;
     mainMenu = std::make_unique<MainMenu>(renderer);
-    mainMenu->addButton({{300, 100, 200, 50}, "Start Game", "start", "", {100, 200, 100}});
-    mainMenu->addButton({{300, 200, 200, 50}, "Exit", "exit", "", {200, 50, 50}});
+    mainMenu->loadConfig("menu_config.json");
+
+    bigFont = assets->openFont("fonts/arial.ttf", 48);
+    smallFont = assets->openFont("fonts/arial.ttf", 24);
+    if (!bigFont || !smallFont) {
+        std::cerr << "Failed to load overlay fonts: " << TTF_GetError() << std::endl;
+    }
+    if (!replayPath.empty()) {
+        startReplay(replayPath);
+    }
 
     return true;
 }
 
-void App::startGame() {
+void App::startGame(const std::string& levelPath) {
     std::cout << "Starting new game..." << std::endl;
-    currentLevel = std::make_unique<Level>(renderer);
-    if (!currentLevel->loadFromFile("levels/level1.txt")) {
+    startClickCounter = SDL_GetPerformanceCounter();
+    firstFrameReported = false;
+
+    prepareRendering();
+    simulation = std::make_unique<Simulation>(*simAssets, jobs.get(), broadcaster.get());
+    simulation->setTimeScale(timeScale);
+    timeScale = simulation->getTimeScale();
+    if (autopilotEnabled) {
+        simulation->setAutopilot(autopilotConfig);
+    }
+    if (!simulation->load(levelPath.empty() ? "levels/level1.txt" : levelPath)) {
         std::cerr << "Failed to load level!" << std::endl;
+        simulation.reset();
         return;
     }
-    currentState = State::PLAYING;
+    if (!recordPath.empty()) {
+        simulation->record(recordPath);
+    }
+    latencyProbe = LatencyProbe();
+    simulation->start(SDL_GetTicks());
+    setState(State::PLAYING);
 }
 
-void App::handleEvents() {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_QUIT) {
-            currentState = State::GAME_OVER;
-            return;
-        }
+void App::prepareRendering() {
+    // Уровень живёт вне потока рендера и текстур не создаёт; всё, что
+    // рисуется, остаётся в потоке рендера у FrameRenderer
+    if (!simAssets) {
+        simAssets = std::make_unique<AssetManager>(nullptr);
+        simAssets->openPack("assets.pak");
+        simAssets->buildManifest({"levels"});
+    }
+    if (!frameRenderer) {
+        frameRenderer = std::make_unique<FrameRenderer>(renderer, *assets);
+    } else {
+        // Версии точек нового уровня начинаются заново
+        frameRenderer->invalidate();
+    }
+}
 
-        switch (currentState) {
-            case State::MENU:
-                if (event.type == SDL_MOUSEBUTTONDOWN) {
-                    int x = event.button.x;
-                    int y = event.button.y;
-                    std::string action = mainMenu->handleClick(x, y);
-                    
-                    if (action == "start") startGame();
-                    else if (action == "exit") currentState = State::GAME_OVER;
-                }
-                break;
-                
-            case State::PLAYING:
-                if (auto pacman = currentLevel->getPacman()) {
-                    if (event.type == SDL_KEYDOWN) {
-                        switch(event.key.keysym.sym) {
-                            case SDLK_UP: pacman->setNextDirection(Direction::UP); break;
-                            case SDLK_DOWN: pacman->setNextDirection(Direction::DOWN); break;
-                            case SDLK_LEFT: pacman->setNextDirection(Direction::LEFT); break;
-                            case SDLK_RIGHT: pacman->setNextDirection(Direction::RIGHT); break;
-                        }
-                    }
-                    if (currentLevel->isGameOver()) {
-                        currentState = State::GAME_OVER;
-                    }
-                }
-                break;
-                
-            case State::GAME_OVER:
-                if (event.type == SDL_KEYDOWN || event.type == SDL_MOUSEBUTTONDOWN) {
-                    currentState = State::MENU;
-                    currentLevel.reset();
-                }
-                break;
+bool App::startReplay(const std::string& path) {
+    auto reader = std::make_unique<ReplayReader>();
+    if (!reader->open(path)) return false;
+
+    prepareRendering();
+    replayLevel = std::make_unique<Level>(nullptr, *simAssets);
+    replayLevel->setJobSystem(jobs.get());
+    replayLevel->loadFromText(reader->getLevelPath(), reader->getLevelText());
+    replayLevel->setRules(reader->getRules());
+    replay = std::move(reader);
+    replayFrame = std::make_unique<FrameSnapshot>();
+    if (!replay->seek(*replayLevel, 0)) {
+        std::cerr << "Failed to start replay " << path << std::endl;
+        stopReplay();
+        return false;
+    }
+
+    std::cout << "Replay " << path << ": " << replay->getTickCount() / kTicksPerSecond
+              << " s of play on " << replay->getLevelPath() << std::endl;
+    replayClockMs = 0.0;
+    replayLastMs = SDL_GetTicks();
+    replayPaused = false;
+    setState(State::REPLAY);
+    return true;
+}
+
+void App::stopReplay() {
+    replay.reset();
+    replayLevel.reset();
+    replayFrame.reset();
+}
+
+void App::seekReplay(int64_t tick) {
+    tick = std::max<int64_t>(0, std::min<int64_t>(tick, static_cast<int64_t>(replay->getTickCount())));
+    if (!replay->seek(*replayLevel, static_cast<uint64_t>(tick))) {
+        std::cerr << "Replay seek to tick " << tick << " failed" << std::endl;
+    }
+    replayClockMs = 0.0;
+    needsRedraw = true;
+}
+
+void App::updateReplay() {
+    if (currentState != State::REPLAY) return;
+
+    const Uint32 now = SDL_GetTicks();
+    if (!replayPaused) replayClockMs += (now - replayLastMs) * static_cast<double>(timeScale);
+    replayLastMs = now;
+
+    const int maxTicks = static_cast<int>(Simulation::kMaxTicksPerWake * std::max(1.0f, timeScale));
+    int ticks = 0;
+    while (replayClockMs >= Simulation::kTickMs && ticks < maxTicks) {
+        if (!replay->step(*replayLevel)) {
+            // Конец записи: стоим на последнем кадре
+            if (replay->getDesyncCount() > 0) {
+                std::cerr << "Replay diverged from the recording at " << replay->getDesyncCount()
+                          << " keyframes" << std::endl;
+            }
+            replayPaused = true;
+            replayClockMs = 0.0;
+            needsRedraw = true;
+            break;
         }
+        replayClockMs -= Simulation::kTickMs;
+        ticks++;
     }
+    if (ticks == maxTicks) replayClockMs = 0.0;
 }
 
-void App::renderGameOverScreen() {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+void App::renderReplayProgress() {
+    const uint64_t total = std::max<uint64_t>(replay->getTickCount(), 1);
+    SDL_Rect frame = {20, 560, 760, 12};
+    SDL_Rect bar = {frame.x + 2, frame.y + 2,
+                    static_cast<int>((frame.w - 4) * replay->getPosition() / total), frame.h - 4};
 
-    if (!currentLevel || !currentLevel->getPacman()) return;
+    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
+    SDL_RenderDrawRect(renderer, &frame);
+    SDL_SetRenderDrawColor(renderer, replayPaused ? 200 : 255, replayPaused ? 200 : 255, 0, 255);
+    SDL_RenderFillRect(renderer, &bar);
+}
 
-    int score = currentLevel->getPacman()->getScore();
+bool App::isAnimating() const {
+    return currentState == State::PLAYING || (currentState == State::REPLAY && !replayPaused);
+}
 
-    TTF_Font* bigFont = TTF_OpenFont("fonts/arial.ttf", 48);
-    if (!bigFont) {
-        std::cerr << "Failed to load big font: " << TTF_GetError() << std::endl;
-        return;
+void App::queueInput(const SDL_KeyboardEvent& key) {
+    Direction dir;
+    switch (key.keysym.sym) {
+        case SDLK_UP: dir = Direction::UP; break;
+        case SDLK_DOWN: dir = Direction::DOWN; break;
+        case SDLK_LEFT: dir = Direction::LEFT; break;
+        case SDLK_RIGHT: dir = Direction::RIGHT; break;
+        default: return;
+    }
+    simulation->pushInput(key.timestamp, dir);
+
+    if (latencyProbeEnabled) {
+        const std::vector<StreamEntity>& entities = simulation->getFrame().world.entities;
+        if (!entities.empty() && entities[0].dir != static_cast<uint8_t>(dir)) {
+            latencyProbe.armed = true;
+            latencyProbe.pressTimestamp = key.timestamp;
+            latencyProbe.dir = dir;
+        }
     }
+}
+
+void App::setState(State state) {
+    currentState = state;
+    needsRedraw = true;
 
+    clearOverlay();
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color yellow = {255, 255, 0, 255};
+    if (state == State::GAME_OVER && simulation) {
+        addOverlayText(bigFont, "GAME OVER", yellow, 200);
+        addOverlayText(bigFont, "YOUR SCORE: " + std::to_string(simulation->getFrame().world.score), white, 300);
+        addOverlayText(smallFont, "Press any key to return to menu", white, 400);
+    } else if (state == State::PAUSED) {
+        addOverlayText(bigFont, "PAUSED", yellow, 250);
+        addOverlayText(smallFont, "Press Esc or P to continue", white, 330);
+    }
+}
 
-    SDL_Surface* gameOverSurface = TTF_RenderText_Solid(bigFont, "GAME OVER", yellow);
-    SDL_Texture* gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-    SDL_Rect gameOverRect = {
-        (800 - gameOverSurface->w) / 2,
-        200,
-        gameOverSurface->w,
-        gameOverSurface->h
-    };
-    SDL_RenderCopy(renderer, gameOverTexture, nullptr, &gameOverRect);
-
-    std::string scoreText = "YOUR SCORE: " + std::to_string(score);
-    SDL_Surface* scoreSurface = TTF_RenderText_Solid(bigFont, scoreText.c_str(), white);
-    SDL_Texture* scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-    SDL_Rect scoreRect = {
-        (800 - scoreSurface->w) / 2,
-        300,
-        scoreSurface->w,
-        scoreSurface->h
-    };
-    SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
-
-    TTF_Font* smallFont = TTF_OpenFont("fonts/arial.ttf", 24);
-    if (smallFont) {
-        SDL_Surface* instructionSurface = TTF_RenderText_Solid(smallFont, "Press any key to return to menu", white);
-        SDL_Texture* instructionTexture = SDL_CreateTextureFromSurface(renderer, instructionSurface);
-        SDL_Rect instructionRect = {
-            (800 - instructionSurface->w) / 2,
-            400,
-            instructionSurface->w,
-            instructionSurface->h
-        };
-        SDL_RenderCopy(renderer, instructionTexture, nullptr, &instructionRect);
-        SDL_FreeSurface(instructionSurface);
-        SDL_DestroyTexture(instructionTexture);
-        TTF_CloseFont(smallFont);
+void App::setPaused(bool paused) {
+    if (!simulation) return;
+    if (paused) {
+        // Отпускание клавиши перемотки на паузе не дойдёт до PLAYING
+        simulation->setRewinding(false);
+        // Поток симуляции стоит, пока игра на паузе; после паузы время
+        // отсчитывается заново, пропущенные тики не навёрстываются
+        simulation->stop();
+        latencyProbe = LatencyProbe();
+        setState(State::PAUSED);
+    } else {
+        simulation->start(SDL_GetTicks());
+        setState(State::PLAYING);
     }
+}
 
-    SDL_FreeSurface(gameOverSurface);
-    SDL_FreeSurface(scoreSurface);
-    SDL_DestroyTexture(gameOverTexture);
-    SDL_DestroyTexture(scoreTexture);
-    TTF_CloseFont(bigFont);
+bool App::handleSpeedKey(SDL_Keycode key) {
+    switch (key) {
+        case SDLK_RIGHTBRACKET:
+        case SDLK_EQUALS:
+        case SDLK_KP_PLUS:
+            timeScale *= 2.0f;
+            break;
+        case SDLK_LEFTBRACKET:
+        case SDLK_MINUS:
+        case SDLK_KP_MINUS:
+            timeScale *= 0.5f;
+            break;
+        case SDLK_0:
+            timeScale = 1.0f;
+            break;
+        default:
+            return false;
+    }
+    timeScale = std::clamp(timeScale, Simulation::kMinTimeScale, Simulation::kMaxTimeScale);
+    if (simulation) simulation->setTimeScale(timeScale);
+    needsRedraw = true;
+    return true;
 }
 
-void App::update(float deltaTime) {
-    if (currentState == State::PLAYING && currentLevel) {
-        currentLevel->update(deltaTime);
+void App::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_QUIT) {
+        quitRequested = true;
+        return;
+    }
+    if (event.type == SDL_RENDER_TARGETS_RESET) {
+        if (frameRenderer) frameRenderer->invalidate();
+        needsRedraw = true;
+    }
+    if (event.type == SDL_WINDOWEVENT) {
+        // Содержимое окна могло пропасть: перекрытие, сворачивание, размер
+        switch (event.window.event) {
+            case SDL_WINDOWEVENT_EXPOSED:
+            case SDL_WINDOWEVENT_SHOWN:
+            case SDL_WINDOWEVENT_RESTORED:
+            case SDL_WINDOWEVENT_SIZE_CHANGED:
+                needsRedraw = true;
+                break;
+            default:
+                break;
+        }
     }
+
+    switch (currentState) {
+        case State::MENU:
+            if (event.type == SDL_MOUSEMOTION) {
+                if (mainMenu->updateHover(event.motion.x, event.motion.y)) needsRedraw = true;
+            } else if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int x = event.button.x;
+                int y = event.button.y;
+                // Переход между экранами меню тоже меняет картинку
+                needsRedraw = true;
+                if (const Button* button = mainMenu->handleClick(x, y)) {
+                    switch (button->action) {
+                        case MenuAction::START: startGame(button->target); break;
+                        case MenuAction::EXIT: quitRequested = true; break;
+                        default:
+                            std::cerr << "Unsupported menu action: " << button->text << std::endl;
+                            break;
+                    }
+                }
+            }
+            break;
+
+        case State::PLAYING:
+            if (event.type == SDL_KEYDOWN && !event.key.repeat) {
+                if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_p) {
+                    setPaused(true);
+                } else if (event.key.keysym.sym == kRewindKey) {
+                    simulation->setRewinding(true);
+                } else if (!handleSpeedKey(event.key.keysym.sym)) {
+                    queueInput(event.key);
+                }
+            } else if (event.type == SDL_KEYUP && event.key.keysym.sym == kRewindKey) {
+                simulation->setRewinding(false);
+            }
+            break;
+
+        case State::PAUSED:
+            if (event.type == SDL_KEYDOWN && !event.key.repeat &&
+                (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_p)) {
+                setPaused(false);
+            }
+            break;
+
+        case State::GAME_OVER:
+            if (event.type == SDL_KEYDOWN || event.type == SDL_MOUSEBUTTONDOWN) {
+                simulation.reset();
+                setState(State::MENU);
+            }
+            break;
+
+        case State::REPLAY:
+            if (event.type == SDL_KEYDOWN) {
+                const int64_t position = static_cast<int64_t>(replay->getPosition());
+                switch (event.key.keysym.sym) {
+                    case SDLK_ESCAPE:
+                        stopReplay();
+                        setState(State::MENU);
+                        break;
+                    case SDLK_SPACE:
+                        replayPaused = !replayPaused;
+                        replayLastMs = SDL_GetTicks();
+                        needsRedraw = true;
+                        break;
+                    case SDLK_LEFT: seekReplay(position - kReplaySeekTicks); break;
+                    case SDLK_RIGHT: seekReplay(position + kReplaySeekTicks); break;
+                    case SDLK_HOME: seekReplay(0); break;
+                    case SDLK_END: seekReplay(static_cast<int64_t>(replay->getTickCount())); break;
+                    default: handleSpeedKey(event.key.keysym.sym); break;
+                }
+            } else if (event.type == SDL_MOUSEBUTTONDOWN && event.button.y >= 556) {
+                // Щелчок по полосе внизу - переход к этому месту записи
+                const double fraction = std::clamp((event.button.x - 22) / 756.0, 0.0, 1.0);
+                seekReplay(static_cast<int64_t>(fraction * replay->getTickCount()));
+            }
+            break;
+    }
+}
+
+void App::clearOverlay() {
+    for (const OverlayText& text : overlay) {
+        SDL_DestroyTexture(text.texture);
+    }
+    overlay.clear();
+}
+
+void App::addOverlayText(TTF_Font* font, const std::string& text, SDL_Color color, int y) {
+    if (!font) return;
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
+    if (!surface) return;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_Rect rect = {(kWindowWidth - surface->w) / 2, y, surface->w, surface->h};
+    SDL_FreeSurface(surface);
+    if (texture) overlay.push_back({texture, rect});
+}
+
+void App::renderOverlay() {
+    for (const OverlayText& text : overlay) {
+        SDL_RenderCopy(renderer, text.texture, nullptr, &text.rect);
+    }
+}
+
+void App::consumeFrame() {
+    if (currentState != State::PLAYING || !simulation) return;
+    if (!simulation->acquireFrame()) return;
+
+    // Поток симуляции сам останавливается после снимка с концом игры
+    if (simulation->getFrame().gameOver) {
+        simulation->stop();
+        setState(State::GAME_OVER);
+    }
+}
+
+void App::reportLatency() {
+    if (!latencyProbe.armed) return;
+    const FrameSnapshot& frame = simulation->getFrame();
+    if (frame.world.entities.empty() || frame.world.entities[0].dir != static_cast<uint8_t>(latencyProbe.dir)) return;
+
+    // SDL_RenderPresent с vsync возвращается после показа кадра
+    std::cout << "Input latency: " << (SDL_GetTicks() - latencyProbe.pressTimestamp)
+              << " ms from key press to presented turn (tick " << frame.tick << ")" << std::endl;
+    latencyProbe.armed = false;
 }
 
 void App::render() {
@@ -214,37 +498,282 @@ void App::render() {
     switch (currentState) {
         case State::MENU:
             mainMenu->render();
+            renderLoadingProgress();
             break;
             
         case State::PLAYING:
-            if (currentLevel) {
-                currentLevel->render();
+            if (simulation) {
+                frameRenderer->render(simulation->getFrame());
             }
             break;
+
+        case State::PAUSED: {
+            // Замерший кадр, затемнённый под надписью
+            frameRenderer->render(simulation->getFrame());
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+            SDL_RenderFillRect(renderer, nullptr);
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+            renderOverlay();
+            break;
+        }
             
         case State::GAME_OVER:
-            renderGameOverScreen();
+            renderOverlay();
+            break;
+
+        case State::REPLAY: {
+            FrameSnapshot& frame = *replayFrame;
+            replayLevel->captureFrame(frame);
+            frame.tick = replay->getPosition();
+            frame.timeScale = timeScale;
+            frame.tickRate = replayPaused ? 0.0f : kTicksPerSecond * timeScale;
+            frameRenderer->render(frame);
+            renderReplayProgress();
             break;
+        }
     }
 
     SDL_RenderPresent(renderer);
+    needsRedraw = false;
+    if (latencyProbeEnabled && currentState == State::PLAYING) {
+        reportLatency();
+    }
+
+    if (currentState == State::PLAYING && !firstFrameReported) {
+        firstFrameReported = true;
+        std::cout << "Time to first playable frame: " << millisecondsSince(startClickCounter)
+                  << " ms after start, " << millisecondsSince(launchCounter) << " ms after launch" << std::endl;
+    }
+}
+
+double App::millisecondsSince(Uint64 counter) const {
+    return (SDL_GetPerformanceCounter() - counter) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void App::renderLoadingProgress() {
+    if (assets->isReady()) return;
+
+    SDL_Rect frame = {200, 540, 400, 16};
+    SDL_Rect bar = {frame.x + 2, frame.y + 2,
+                    static_cast<int>((frame.w - 4) * assets->getProgress()), frame.h - 4};
+
+    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
+    SDL_RenderDrawRect(renderer, &frame);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+    SDL_RenderFillRect(renderer, &bar);
+}
+
+int App::idleTimeoutMs() const {
+    // Пока ресурсы грузятся, нужно выгружать их в GPU и двигать полосу загрузки
+    if (currentState == State::MENU && !assets->isReady()) return kLoadingPollMs;
+    return MainMenu::kReloadCheckInterval;
 }
 
 void App::run() {
-    Uint32 lastTime = SDL_GetTicks();
-    bool running = true;
-    
-    while (running) {
-        Uint32 currentTime = SDL_GetTicks();
-        float deltaTime = (currentTime - lastTime) / 1000.0f;
-        lastTime = currentTime;
+    while (!quitRequested) {
+        SDL_Event event;
+        if (isAnimating()) {
+            while (SDL_PollEvent(&event)) handleEvent(event);
+        } else {
+            // Меню, пауза и конец игры меняются только от событий: поток спит
+            // в ожидании, а не рисует одну и ту же картинку с частотой vsync
+            if (SDL_WaitEventTimeout(&event, idleTimeoutMs())) {
+                handleEvent(event);
+                while (!quitRequested && SDL_PollEvent(&event)) handleEvent(event);
+            }
+        }
+        if (quitRequested) break;
+
+        if (currentState == State::MENU) {
+            if (mainMenu->reloadIfChanged()) needsRedraw = true;
+        }
 
-        handleEvents();
-        if (currentState == State::GAME_OVER && !(currentLevel && currentLevel->isGameOver())) {
-            running = false;
+        if (!assetsReported) {
+            assets->uploadPending(4);
+            needsRedraw = true; // полоса загрузки
+            if (assets->isReady()) {
+                assetsReported = true;
+                std::cout << "Assets ready: " << assets->getAssetCount() << " files in "
+                          << millisecondsSince(launchCounter) << " ms after launch" << std::endl;
+            }
         }
 
-        update(deltaTime);
-        render();
+        consumeFrame();
+        updateReplay();
+        if (isAnimating() || needsRedraw) {
+            render();
+        }
     }
-}
\ No newline at end of file
+}
+
+int App::runHeadless(const std::string& levelPath, uint64_t maxTicks, const Autopilot::Config& config,
+                     const std::string& broadcastPath) {
+    JobSystem jobs;
+    AssetManager assets(nullptr);
+    if (!assets.openPack("assets.pak")) {
+        std::cout << "assets.pak not found, loading loose asset files" << std::endl;
+    }
+    assets.buildManifest({"levels"});
+
+    StateBroadcaster broadcaster;
+    if (!broadcastPath.empty()) {
+        if (!broadcaster.listen(broadcastPath)) return 1;
+        std::cout << "Broadcasting game state on " << broadcastPath << std::endl;
+    }
+
+    Level level(nullptr, assets);
+    level.setJobSystem(&jobs);
+    if (broadcaster.isListening()) level.setStateStream(&broadcaster);
+    if (!level.loadFromFile(levelPath)) {
+        std::cerr << "Failed to load level!" << std::endl;
+        return 1;
+    }
+
+    Autopilot bot(config, &jobs);
+    const uint64_t reportTicks = static_cast<uint64_t>(kTicksPerSecond) * 60;
+    Uint64 start = SDL_GetPerformanceCounter();
+    uint64_t games = 0;
+    int64_t scoreSum = 0;
+
+    std::cout << "Headless run: " << levelPath << ", " << config.budgetMs << " ms per decision, "
+              << jobs.getWorkerCount() + 1 << " search threads" << std::endl;
+
+    for (uint64_t tick = 1; maxTicks == 0 || tick <= maxTicks; ++tick) {
+        Direction dir = bot.decide(level);
+        if (dir != Direction::NONE) level.getPacman()->setNextDirection(dir);
+        level.update(kTickSeconds);
+        // Хэш ведётся по изменениям, в том числе из параллельной фазы ИИ
+        // призраков; прогон сверяет его с пересчётом по всему уровню
+        if (level.getStateHash() != level.computeStateHash()) {
+            std::cerr << "State hash mismatch at tick " << tick << ": incremental " << std::hex
+                      << level.getStateHash() << ", recomputed " << level.computeStateHash() << std::dec << std::endl;
+            return 1;
+        }
+
+        if (level.isGameOver()) {
+            games++;
+            scoreSum += level.getPacman()->getScore();
+            std::cout << "Game " << games << " over at tick " << tick
+                      << ", score " << level.getPacman()->getScore() << std::endl;
+            level.restartLevel(false);
+        }
+
+        if (tick % reportTicks == 0 || tick == maxTicks) {
+            double seconds = (SDL_GetPerformanceCounter() - start) / static_cast<double>(SDL_GetPerformanceFrequency());
+            std::cout << "Ticks: " << tick << " (" << tick / kTicksPerSecond << " s of play) in " << seconds
+                      << " s, games: " << games << ", average score: " << (games ? scoreSum / static_cast<int64_t>(games) : 0)
+                      << ", rollouts: " << bot.getTotalIterations() << ", state hash: " << std::hex
+                      << level.getStateHash() << std::dec << std::endl;
+        }
+    }
+    return 0;
+}
+
+int App::runCapture(const std::string& levelPath, uint64_t maxTicks, const Autopilot::Config& config,
+                    const std::string& capturePath, int fps) {
+    if (TTF_Init() == -1) {
+        std::cerr << "TTF_Init Error: " << TTF_GetError() << std::endl;
+        return 1;
+    }
+    if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG) {
+        std::cerr << "IMG_Init Error: " << IMG_GetError() << std::endl;
+        TTF_Quit();
+        return 1;
+    }
+    // Окна и видеодрайвера нет: программный рендерер рисует прямо в поверхность
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, kWindowWidth, kWindowHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (!renderer) {
+        std::cerr << "Software renderer Error: " << SDL_GetError() << std::endl;
+        if (surface) SDL_FreeSurface(surface);
+        IMG_Quit();
+        TTF_Quit();
+        return 1;
+    }
+
+    int result = 0;
+    {
+        JobSystem jobs;
+        AssetManager assets(renderer);
+        if (!assets.openPack("assets.pak")) {
+            std::cout << "assets.pak not found, loading loose asset files" << std::endl;
+        }
+        assets.buildManifest({"sprites", "fonts", "levels"});
+
+        Level level(renderer, assets);
+        level.setJobSystem(&jobs);
+        FrameCapture capture;
+        // Кадр - целое число тиков, частота записи округляется до делителя kTicksPerSecond
+        const int ticksPerFrame = kTicksPerSecond / std::clamp(fps, 1, kTicksPerSecond);
+        fps = kTicksPerSecond / ticksPerFrame;
+        if (!level.loadFromFile(levelPath)) {
+            std::cerr << "Failed to load level!" << std::endl;
+            result = 1;
+        } else if (!capture.open(capturePath, kWindowWidth, kWindowHeight, fps)) {
+            result = 1;
+        }
+
+        Autopilot bot(config, &jobs);
+        const uint64_t reportTicks = static_cast<uint64_t>(kTicksPerSecond) * 60;
+        const Uint64 start = SDL_GetPerformanceCounter();
+        double renderMs = 0.0;
+        uint64_t frames = 0;
+        if (result == 0) {
+            std::cout << "Capturing " << levelPath << " to " << capturePath << " at " << fps << " fps"
+                      << (maxTicks == 0 ? ", until Ctrl+C" : "") << std::endl;
+        }
+
+        auto report = [&](uint64_t tick) {
+            const double seconds = (SDL_GetPerformanceCounter() - start) / static_cast<double>(SDL_GetPerformanceFrequency());
+            std::cout << "Frames: " << frames << " (" << tick / kTicksPerSecond << " s of play) in " << seconds
+                      << " s, " << frames / seconds << " fps; per frame: render " << renderMs / std::max<uint64_t>(frames, 1)
+                      << " ms, encode " << capture.getEncodeMs() << " ms; waited for writer "
+                      << capture.getStallMs() << " ms" << std::endl;
+        };
+
+        captureInterrupted = 0;
+        auto previousInt = std::signal(SIGINT, onCaptureSignal);
+        auto previousTerm = std::signal(SIGTERM, onCaptureSignal);
+        uint64_t tick = 0;
+        while (result == 0 && (maxTicks == 0 || tick < maxTicks) && !captureInterrupted) {
+            ++tick;
+            Direction dir = bot.decide(level);
+            if (dir != Direction::NONE) level.getPacman()->setNextDirection(dir);
+            level.tick();
+            if (level.isGameOver()) {
+                std::cout << "Game over at tick " << tick << ", score " << level.getPacman()->getScore() << std::endl;
+                level.restartLevel(false);
+            }
+
+            if (tick % ticksPerFrame == 0) {
+                const Uint64 renderStart = SDL_GetPerformanceCounter();
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+                SDL_RenderClear(renderer);
+                level.render();
+                // Команды рендерера копятся пачкой, до чтения поверхности их надо выполнить
+                SDL_RenderFlush(renderer);
+                renderMs += (SDL_GetPerformanceCounter() - renderStart) * 1000.0 / SDL_GetPerformanceFrequency();
+                capture.submit(surface);
+                frames++;
+            }
+
+            if (tick % reportTicks == 0) report(tick);
+        }
+        std::signal(SIGINT, previousInt);
+        std::signal(SIGTERM, previousTerm);
+
+        // Кадры, ещё стоящие в очереди, дописываются до выхода
+        capture.close();
+        if (result == 0) {
+            if (captureInterrupted) std::cout << "Capture interrupted at tick " << tick << std::endl;
+            report(tick);
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    IMG_Quit();
+    TTF_Quit();
+    return result;
+}
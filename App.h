@@ -1,9 +1,21 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
 #include <memory>
+#include <string>
+#include <vector>
+#include "Autopilot.h"
+#include "FixedPoint.h"
 
 class MainMenu;
+class JobSystem;
+class AssetManager;
+class StateBroadcaster;
+class Simulation;
+class FrameRenderer;
 class Level;
+class ReplayReader;
+struct FrameSnapshot;
 
 class App {
 public:
@@ -12,22 +24,125 @@ public:
     
     bool init();
     void run();
+    // Режим замера задержки: от нажатия клавиши до кадра с поворотом
+    void setLatencyProbe(bool enabled) { latencyProbeEnabled = enabled; }
+    // Демо-режим: Пакманом управляет автопилот
+    void setAutopilot(const Autopilot::Config& config) { autopilotEnabled = true; autopilotConfig = config; }
+    // Начальный масштаб времени симуляции (x0.25 - x64), в игре меняется
+    // клавишами [ ] (или - =), 0 - обратно x1
+    void setTimeScale(float scale) { timeScale = scale; }
+    // Трансляция состояния игры зрителям через Unix-сокет (см. StateStream)
+    void setBroadcastPath(const std::string& path) { broadcastPath = path; }
+    // Запись каждой игры в файл повтора (см. Replay)
+    void setRecordPath(const std::string& path) { recordPath = path; }
+    // Просмотр повтора вместо игры: пробел - пауза, стрелки - перемотка на
+    // 10 с, Home/End - начало и конец, щелчок по полосе - переход
+    void setReplayPath(const std::string& path) { replayPath = path; }
+
+    // Игра без окна под управлением автопилота (нагрузочные прогоны).
+    // maxTicks == 0 - до прерывания; broadcastPath - сокет для зрителей.
+    // Каждый тик хэш состояния сверяется с полным пересчётом: при
+    // расхождении прогон завершается с кодом 1
+    static int runHeadless(const std::string& levelPath, uint64_t maxTicks, const Autopilot::Config& config,
+                           const std::string& broadcastPath = "");
+    // Игра автопилота без окна с записью кадров (см. FrameCapture): кадры
+    // рисует программный рендерер в поверхность в памяти, так что нужен
+    // только процессор. fps - частота кадров записи, тики идут без ожидания.
+    // maxTicks == 0 - до Ctrl+C (SIGINT) или SIGTERM: очередь кадров
+    // дописывается, и файл закрывается как при обычном конце
+    static int runCapture(const std::string& levelPath, uint64_t maxTicks, const Autopilot::Config& config,
+                          const std::string& capturePath, int fps);
     
     App(const App&) = delete;
     App& operator=(const App&) = delete;
     
 private:
-    enum class State { MENU, PLAYING, GAME_OVER };
+    enum class State { MENU, PLAYING, PAUSED, GAME_OVER, REPLAY };
+
+    static const int kWindowWidth = 800;
+    static const int kWindowHeight = 600;
+
+    // Опрос событий, пока ресурсы ещё загружаются
+    static const int kLoadingPollMs = 16;
+    // Шаг перемотки повтора стрелками
+    static const int kReplaySeekTicks = 10 * kTicksPerSecond;
+    // Пока зажата, игра отматывается назад (см. RewindBuffer)
+    static const SDL_Keycode kRewindKey = SDLK_BACKSPACE;
+
+    // Надпись экрана паузы или конца игры, отрисованная при входе в него
+    struct OverlayText {
+        SDL_Texture* texture;
+        SDL_Rect rect;
+    };
+
+    struct LatencyProbe {
+        bool armed = false;
+        Uint32 pressTimestamp = 0;
+        Direction dir;
+    };
     
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
     std::unique_ptr<MainMenu> mainMenu;
-    std::unique_ptr<Level> currentLevel;
+    std::unique_ptr<JobSystem> jobs;
+    std::unique_ptr<AssetManager> assets;
+    // Ресурсы уровня для потока симуляции, без рендерера
+    std::unique_ptr<AssetManager> simAssets;
+    std::unique_ptr<Simulation> simulation;
+    std::unique_ptr<FrameRenderer> frameRenderer;
     State currentState = State::MENU;
+    bool quitRequested = false;
+    // Вне игры кадр перерисовывается только после изменений
+    bool needsRedraw = true;
+    TTF_Font* bigFont = nullptr;
+    TTF_Font* smallFont = nullptr;
+    std::vector<OverlayText> overlay;
+
+    // Замеры времени запуска (SDL_GetPerformanceCounter)
+    Uint64 launchCounter = 0;
+    Uint64 startClickCounter = 0;
+    bool assetsReported = false;
+    bool firstFrameReported = false;
+
+    bool latencyProbeEnabled = false;
+    LatencyProbe latencyProbe;
+    bool autopilotEnabled = false;
+    Autopilot::Config autopilotConfig;
+    float timeScale = 1.0f;
+    std::string broadcastPath;
+    std::unique_ptr<StateBroadcaster> broadcaster;
+    std::string recordPath;
+
+    // Повтор проигрывается в потоке рендера: тики дешёвые, а перемотка
+    // должна сразу менять кадр
+    std::string replayPath;
+    std::unique_ptr<ReplayReader> replay;
+    std::unique_ptr<Level> replayLevel;
+    std::unique_ptr<FrameSnapshot> replayFrame;
+    double replayClockMs = 0.0; // несыгранное время в мс игры
+    Uint32 replayLastMs = 0;
+    bool replayPaused = false;
     
-    void handleEvents();
-    void update(float deltaTime);
+    void handleEvent(const SDL_Event& event);
+    void setState(State state);
+    void setPaused(bool paused);
+    int idleTimeoutMs() const;
+    void queueInput(const SDL_KeyboardEvent& key);
+    bool handleSpeedKey(SDL_Keycode key);
+    void consumeFrame();
+    void reportLatency();
     void render();
-    void startGame();
-    void renderGameOverScreen();
+    void startGame(const std::string& levelPath);
+    void prepareRendering();
+    bool startReplay(const std::string& path);
+    void stopReplay();
+    void seekReplay(int64_t tick);
+    void updateReplay();
+    void renderReplayProgress();
+    bool isAnimating() const;
+    void clearOverlay();
+    void addOverlayText(TTF_Font* font, const std::string& text, SDL_Color color, int y);
+    void renderOverlay();
+    void renderLoadingProgress();
+    double millisecondsSince(Uint64 counter) const;
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "ObjectPool.h"
+
+// Хранилище сущностей одного архетипа - одного набора компонентов.
+// Сущности лежат блоками по ChunkSize, внутри блока у каждого компонента
+// свой плотный массив, поэтому система, которой нужны два компонента из
+// пяти, читает только их. Индекс сущности - порядок добавления; удаление
+// переносит последнюю сущность на место удалённой. Блоки не возвращаются
+// в кучу до уничтожения архетипа: clear() переиспользует их в следующем
+// раунде, как ObjectPool.
+template <size_t ChunkSize, typename... Components>
+class Archetype {
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+    struct Chunk {
+        std::tuple<std::array<Components, ChunkSize>...> columns;
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    size_t count = 0;
+    PoolStats stats;
+
+    void grow() {
+        chunks.emplace_back(new Chunk);
+        stats.chunkAllocations++;
+        stats.capacity += ChunkSize;
+    }
+
+    template <typename C>
+    static C* columnOf(Chunk& chunk) {
+        return std::get<std::array<C, ChunkSize>>(chunk.columns).data();
+    }
+
+    template <size_t... I>
+    void move(size_t from, size_t to, std::index_sequence<I...>) {
+        Chunk& source = *chunks[from / ChunkSize];
+        Chunk& target = *chunks[to / ChunkSize];
+        ((std::get<I>(target.columns)[to % ChunkSize] = std::get<I>(source.columns)[from % ChunkSize]), ...);
+    }
+
+public:
+    static const size_t kChunkSize = ChunkSize;
+
+    Archetype() = default;
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    void reserve(size_t capacity) {
+        while (stats.capacity < capacity) grow();
+    }
+
+    size_t add(const Components&... values) {
+        if (count == stats.capacity) grow();
+        const size_t index = count++;
+        Chunk& chunk = *chunks[index / ChunkSize];
+        ((columnOf<Components>(chunk)[index % ChunkSize] = values), ...);
+        stats.constructed++;
+        stats.live = count;
+        return index;
+    }
+
+    // Последняя сущность переезжает на место index; возвращает её прежний
+    // индекс (равен index, если удалена последняя)
+    size_t remove(size_t index) {
+        const size_t last = --count;
+        if (index != last) move(last, index, std::index_sequence_for<Components...>{});
+        stats.destroyed++;
+        stats.live = count;
+        return last;
+    }
+
+    void clear() {
+        stats.destroyed += count;
+        count = 0;
+        stats.live = 0;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    template <typename C>
+    C& get(size_t index) {
+        return columnOf<C>(*chunks[index / ChunkSize])[index % ChunkSize];
+    }
+
+    template <typename C>
+    const C& get(size_t index) const {
+        return columnOf<C>(*chunks[index / ChunkSize])[index % ChunkSize];
+    }
+
+    // Обход по блокам: сущности блока chunk - индексы с chunk * ChunkSize,
+    // их chunkLength(chunk) штук, компоненты - column<C>(chunk)[0..length)
+    size_t chunkCount() const { return (count + ChunkSize - 1) / ChunkSize; }
+    size_t chunkLength(size_t chunk) const {
+        const size_t begin = chunk * ChunkSize;
+        return count - begin < ChunkSize ? count - begin : ChunkSize;
+    }
+
+    template <typename C>
+    C* column(size_t chunk) {
+        return columnOf<C>(*chunks[chunk]);
+    }
+
+    template <typename C>
+    const C* column(size_t chunk) const {
+        return columnOf<C>(*chunks[chunk]);
+    }
+
+    const PoolStats& getStats() const { return stats; }
+};
@@ -0,0 +1,271 @@
+#include "AssetManager.h"
+#include "JobSystem.h"
+#include <SDL2/SDL_image.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+    AssetManager::AssetKind kindFromExtension(const std::string& extension) {
+        if (extension == ".png") return AssetManager::AssetKind::IMAGE;
+        if (extension == ".ttf") return AssetManager::AssetKind::FONT;
+        if (extension == ".txt") return AssetManager::AssetKind::LEVEL;
+        return AssetManager::AssetKind::OTHER;
+    }
+
+    bool readFile(const std::string& path, std::vector<char>& out) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+AssetManager::AssetManager(SDL_Renderer* renderer) : renderer(renderer) {}
+
+AssetManager::~AssetManager() {
+    cancelled = true;
+    if (loader.joinable()) loader.join();
+
+    for (auto& asset : assets) {
+        if (asset->surface) SDL_FreeSurface(asset->surface);
+        if (asset->texture) SDL_DestroyTexture(asset->texture);
+    }
+    for (auto& entry : extraTextures) {
+        if (entry.second) SDL_DestroyTexture(entry.second);
+    }
+}
+
+bool AssetManager::openPack(const std::string& path) {
+    if (!pack.open(path)) return false;
+    std::cout << "Asset pack: " << path << ", " << pack.getEntries().size() << " entries" << std::endl;
+    return true;
+}
+
+void AssetManager::buildManifest(const std::vector<std::string>& roots) {
+    if (pack.isOpen()) {
+        for (const auto& entry : pack.getEntries()) {
+            bool underRoot = false;
+            for (const auto& root : roots) {
+                underRoot = underRoot || entry.path.compare(0, root.size() + 1, root + "/") == 0;
+            }
+            if (!underRoot) continue;
+
+            auto asset = std::make_unique<Asset>();
+            asset->path = entry.path;
+            asset->kind = kindFromExtension(fs::path(entry.path).extension().string());
+            asset->packed = &entry;
+            index[asset->path] = assets.size();
+            assets.push_back(std::move(asset));
+        }
+        std::cout << "Asset manifest: " << assets.size() << " files (packed)" << std::endl;
+        return;
+    }
+
+    for (const auto& root : roots) {
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file()) continue;
+
+            auto asset = std::make_unique<Asset>();
+            asset->path = it->path().generic_string();
+            asset->kind = kindFromExtension(it->path().extension().string());
+            index[asset->path] = assets.size();
+            assets.push_back(std::move(asset));
+        }
+        if (ec) {
+            std::cerr << "Asset manifest: cannot scan " << root << ": " << ec.message() << std::endl;
+        }
+    }
+    std::cout << "Asset manifest: " << assets.size() << " files" << std::endl;
+}
+
+void AssetManager::startLoading(JobSystem& jobs) {
+    loader = std::thread([this, &jobs] {
+        Uint64 start = SDL_GetPerformanceCounter();
+        jobs.parallelFor(assets.size(), 1, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end && !cancelled; ++i) {
+                claimAndDecode(*assets[i]);
+            }
+        });
+        double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+        std::cout << "Assets decoded in " << ms << " ms" << std::endl;
+    });
+}
+
+void AssetManager::decode(Asset& asset) {
+    bool ok = false;
+    if (asset.packed) {
+        // Данные уже в памяти: изображения декодированы упаковщиком
+        asset.data = reinterpret_cast<const char*>(pack.data(*asset.packed));
+        asset.size = asset.packed->size;
+        ok = asset.kind != AssetKind::IMAGE || asset.packed->kind == AssetPack::Kind::IMAGE_RGBA32;
+        if (!ok) std::cerr << "Packed image " << asset.path << " is not RGBA32" << std::endl;
+    } else {
+        switch (asset.kind) {
+            case AssetKind::IMAGE:
+                asset.surface = IMG_Load(asset.path.c_str());
+                ok = asset.surface != nullptr;
+                if (!ok) std::cerr << "Failed to decode " << asset.path << ": " << IMG_GetError() << std::endl;
+                break;
+
+            case AssetKind::FONT:
+            case AssetKind::LEVEL:
+            case AssetKind::OTHER:
+                ok = readFile(asset.path, asset.bytes);
+                if (!ok) std::cerr << "Failed to read " << asset.path << std::endl;
+                asset.data = asset.bytes.data();
+                asset.size = asset.bytes.size();
+                break;
+        }
+    }
+
+    if (!ok) {
+        asset.state = FAILED;
+        finishedCount++;
+    } else if (asset.kind == AssetKind::IMAGE) {
+        asset.state = DECODED;
+    } else {
+        asset.state = READY;
+        finishedCount++;
+    }
+}
+
+bool AssetManager::claimAndDecode(Asset& asset) {
+    int expected = PENDING;
+    if (!asset.state.compare_exchange_strong(expected, DECODING)) return false;
+    decode(asset);
+    return true;
+}
+
+void AssetManager::waitDecoded(Asset& asset) {
+    // Ресурс обрабатывается другим потоком - ждём, это доли миллисекунды
+    while (asset.state.load() == DECODING) {
+        std::this_thread::yield();
+    }
+}
+
+void AssetManager::upload(Asset& asset) {
+    if (asset.state.load() != DECODED) return;
+
+    if (renderer && asset.packed) {
+        // Пиксели копируются в текстуру прямо из отображённого архива
+        const AssetPack::Entry& entry = *asset.packed;
+        asset.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                          entry.width, entry.height);
+        if (asset.texture) {
+            SDL_SetTextureBlendMode(asset.texture, SDL_BLENDMODE_BLEND);
+            SDL_UpdateTexture(asset.texture, nullptr, asset.data, entry.pitch);
+        }
+    } else if (renderer) {
+        asset.texture = SDL_CreateTextureFromSurface(renderer, asset.surface);
+    }
+    if (renderer && !asset.texture) {
+        std::cerr << "Failed to upload " << asset.path << ": " << SDL_GetError() << std::endl;
+    }
+    if (asset.surface) SDL_FreeSurface(asset.surface);
+    asset.surface = nullptr;
+    asset.state = asset.texture || !renderer ? READY : FAILED;
+    finishedCount++;
+}
+
+void AssetManager::uploadPending(Uint32 budgetMs) {
+    Uint32 start = SDL_GetTicks();
+    while (uploadCursor < assets.size()) {
+        Asset& asset = *assets[uploadCursor];
+        int state = asset.state.load();
+        if (state == PENDING || state == DECODING) return; // ещё декодируется
+        if (state == DECODED) upload(asset);
+        uploadCursor++;
+
+        if (SDL_GetTicks() - start >= budgetMs) return;
+    }
+}
+
+float AssetManager::getProgress() const {
+    if (assets.empty()) return 1.0f;
+    return static_cast<float>(finishedCount.load()) / assets.size();
+}
+
+bool AssetManager::isReady() const {
+    return finishedCount.load() == assets.size();
+}
+
+AssetManager::Asset* AssetManager::find(const std::string& path) {
+    auto it = index.find(path);
+    return it == index.end() ? nullptr : assets[it->second].get();
+}
+
+SDL_Texture* AssetManager::getTexture(const std::string& path, SDL_Renderer* target) {
+    if (!target || !renderer) return nullptr;
+    if (target != renderer) {
+        std::cerr << "Texture " << path << " requested for a renderer other than the asset manager's" << std::endl;
+        return nullptr;
+    }
+
+    if (Asset* asset = find(path)) {
+        claimAndDecode(*asset);
+        waitDecoded(*asset);
+        upload(*asset);
+        return asset->texture;
+    }
+
+    // Файл вне манифеста - загружаем напрямую и кэшируем
+    auto it = extraTextures.find(path);
+    if (it != extraTextures.end()) return it->second;
+
+    SDL_Texture* texture = IMG_LoadTexture(renderer, path.c_str());
+    if (!texture) {
+        std::cerr << "Failed to load " << path << ": " << IMG_GetError() << std::endl;
+    }
+    extraTextures[path] = texture;
+    return texture;
+}
+
+TTF_Font* AssetManager::openFont(const std::string& path, int size) {
+    Asset* asset = find(path);
+    if (asset) {
+        claimAndDecode(*asset);
+        waitDecoded(*asset);
+    }
+    if (!asset || asset->state.load() != READY || asset->size == 0) {
+        return TTF_OpenFont(path.c_str(), size);
+    }
+    return TTF_OpenFontRW(SDL_RWFromConstMem(asset->data, static_cast<int>(asset->size)), 1, size);
+}
+
+bool AssetManager::readText(const std::string& path, std::string& out) {
+    {
+        std::lock_guard<std::mutex> lock(reloadedMutex);
+        auto it = reloaded.find(path);
+        if (it != reloaded.end()) {
+            out = it->second;
+            return true;
+        }
+    }
+    Asset* asset = find(path);
+    if (asset) {
+        claimAndDecode(*asset);
+        waitDecoded(*asset);
+    }
+    if (!asset || asset->state.load() != READY) {
+        std::vector<char> bytes;
+        if (!readFile(path, bytes)) return false;
+        out.assign(bytes.begin(), bytes.end());
+        return true;
+    }
+    out.assign(asset->data, asset->size);
+    return true;
+}
+
+bool AssetManager::reloadText(const std::string& path, std::string& out) {
+    std::vector<char> bytes;
+    if (!readFile(path, bytes)) return false;
+    out.assign(bytes.begin(), bytes.end());
+    std::lock_guard<std::mutex> lock(reloadedMutex);
+    reloaded[path] = out;
+    return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "AssetPack.h"
+
+class JobSystem;
+
+// Ресурсы игры. При запуске составляется манифест всех файлов в каталогах
+// ресурсов, PNG декодируются в SDL_Surface на пуле потоков, а шрифты и
+// уровни читаются в память. В поток рендера попадает только загрузка
+// текстур на GPU (uploadPending). Если ресурс запрошен раньше, чем его
+// обработал фоновый поток, он загружается синхронно.
+// Если открыт архив assets.pak, манифест берётся из его индекса, а
+// изображения, шрифты и уровни читаются прямо из отображённого файла.
+class AssetManager {
+public:
+    enum class AssetKind { IMAGE, FONT, LEVEL, OTHER };
+
+    explicit AssetManager(SDL_Renderer* renderer);
+    ~AssetManager();
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    // Вызывается до buildManifest; без архива ресурсы читаются из файлов
+    bool openPack(const std::string& path);
+    void buildManifest(const std::vector<std::string>& roots);
+    void startLoading(JobSystem& jobs);
+
+    // Загружает декодированные изображения на GPU, пока не истечёт budgetMs
+    void uploadPending(Uint32 budgetMs);
+
+    size_t getAssetCount() const { return assets.size(); }
+    bool hasRenderer() const { return renderer != nullptr; }
+    float getProgress() const;
+    bool isReady() const;
+
+    // Текстуры принадлежат менеджеру и создаются на его рендерере.
+    // target - рендерер вызывающего: без него (headless-уровень) - nullptr,
+    // даже если у менеджера рендерер есть, так что уровень в другом потоке
+    // не создаёт текстур на чужом рендерере. target другого рендерера - ошибка
+    SDL_Texture* getTexture(const std::string& path, SDL_Renderer* target);
+    // Шрифт создаётся из байтов в памяти, закрывает его вызывающий
+    TTF_Font* openFont(const std::string& path, int size);
+    bool readText(const std::string& path, std::string& out);
+    // Заново читает файл с диска (его изменили во время игры): дальше
+    // readText отдаёт новое содержимое вместо копии из манифеста или архива
+    bool reloadText(const std::string& path, std::string& out);
+
+private:
+    enum State { PENDING, DECODING, DECODED, READY, FAILED };
+
+    struct Asset {
+        std::string path;
+        AssetKind kind = AssetKind::OTHER;
+        std::atomic<int> state{PENDING};
+        SDL_Surface* surface = nullptr;
+        SDL_Texture* texture = nullptr;
+        std::vector<char> bytes;
+        const AssetPack::Entry* packed = nullptr;
+        // Содержимое файла: bytes или участок архива
+        const char* data = nullptr;
+        size_t size = 0;
+    };
+
+    SDL_Renderer* renderer;
+    AssetPack pack;
+    std::vector<std::unique_ptr<Asset>> assets;
+    std::unordered_map<std::string, size_t> index;
+    std::unordered_map<std::string, SDL_Texture*> extraTextures;
+    std::mutex reloadedMutex;
+    std::unordered_map<std::string, std::string> reloaded; // под reloadedMutex
+    std::thread loader;
+    std::atomic<bool> cancelled{false};
+    std::atomic<size_t> finishedCount{0};
+    size_t uploadCursor = 0;
+
+    Asset* find(const std::string& path);
+    void decode(Asset& asset);
+    bool claimAndDecode(Asset& asset);
+    void waitDecoded(Asset& asset);
+    void upload(Asset& asset);
+};
@@ -0,0 +1,183 @@
+#include "AssetPack.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASSETPACK_HAS_MMAP 1
+#endif
+
+namespace {
+    const char kMagic[4] = {'P', 'K', 'P', 'K'};
+    const uint32_t kVersion = 1;
+    const size_t kHeaderSize = 4 + 4 + 4 + 8;
+    const size_t kAlignment = 16;
+
+    template <typename T>
+    void put(std::vector<unsigned char>& out, T value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    // Читатель индекса с проверкой границ
+    struct Reader {
+        const unsigned char* data;
+        size_t size;
+        size_t pos;
+
+        template <typename T>
+        bool get(T& value) {
+            if (pos + sizeof(T) > size) return false;
+            std::memcpy(&value, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+
+        bool getString(std::string& value, size_t length) {
+            if (pos + length > size) return false;
+            value.assign(reinterpret_cast<const char*>(data + pos), length);
+            pos += length;
+            return true;
+        }
+    };
+
+    // Данные записи целиком лежат до индекса (сумма смещения и размера
+    // может переполниться, поэтому сравнение без неё). Изображение
+    // SDL_UpdateTexture читает построчно: pitch * height байт прямо из
+    // отображения, и строка должна вмещать width пикселей RGBA32
+    bool entryFits(const AssetPack::Entry& entry, uint8_t kind, uint64_t indexOffset) {
+        if (entry.size > indexOffset || entry.offset > indexOffset - entry.size) return false;
+        if (kind == static_cast<uint8_t>(AssetPack::Kind::RAW)) return true;
+        if (kind != static_cast<uint8_t>(AssetPack::Kind::IMAGE_RGBA32)) return false;
+        return entry.width > 0 && entry.height > 0 && entry.pitch >= static_cast<uint64_t>(entry.width) * 4 &&
+               entry.size >= static_cast<uint64_t>(entry.pitch) * entry.height;
+    }
+}
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+void AssetPack::close() {
+#ifdef ASSETPACK_HAS_MMAP
+    if (base && fallbackBuffer.empty()) {
+        munmap(const_cast<unsigned char*>(base), mappedSize);
+    }
+#endif
+    base = nullptr;
+    mappedSize = 0;
+    fallbackBuffer.clear();
+    entries.clear();
+    index.clear();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+
+#ifdef ASSETPACK_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(kHeaderSize)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    base = static_cast<const unsigned char*>(mapped);
+    mappedSize = info.st_size;
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    fallbackBuffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (fallbackBuffer.size() < kHeaderSize) {
+        fallbackBuffer.clear();
+        return false;
+    }
+    base = fallbackBuffer.data();
+    mappedSize = fallbackBuffer.size();
+#endif
+
+    Reader header{base, mappedSize, 0};
+    char magic[4];
+    uint32_t version = 0, count = 0;
+    uint64_t indexOffset = 0;
+    std::memcpy(magic, base, 4);
+    header.pos = 4;
+    if (std::memcmp(magic, kMagic, 4) != 0 || !header.get(version) || version != kVersion ||
+        !header.get(count) || !header.get(indexOffset) || indexOffset < kHeaderSize || indexOffset > mappedSize) {
+        std::cerr << "Asset pack " << path << " has an invalid header" << std::endl;
+        close();
+        return false;
+    }
+
+    Reader reader{base, mappedSize, static_cast<size_t>(indexOffset)};
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        Entry entry;
+        uint32_t pathLength = 0;
+        uint8_t kind = 0;
+        if (!reader.get(pathLength) || !reader.getString(entry.path, pathLength) || !reader.get(kind) ||
+            !reader.get(entry.width) || !reader.get(entry.height) || !reader.get(entry.pitch) ||
+            !reader.get(entry.offset) || !reader.get(entry.size) || !entryFits(entry, kind, indexOffset)) {
+            std::cerr << "Asset pack " << path << " has a corrupt index" << std::endl;
+            close();
+            return false;
+        }
+        entry.kind = static_cast<Kind>(kind);
+        index[entry.path] = entries.size();
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+const AssetPack::Entry* AssetPack::find(const std::string& path) const {
+    auto it = index.find(path);
+    return it == index.end() ? nullptr : &entries[it->second];
+}
+
+bool AssetPack::write(const std::string& path, const std::vector<Entry>& entries,
+                      const std::vector<std::vector<unsigned char>>& blobs) {
+    std::vector<unsigned char> out;
+    out.insert(out.end(), kMagic, kMagic + 4);
+    put<uint32_t>(out, kVersion);
+    put<uint32_t>(out, static_cast<uint32_t>(entries.size()));
+    put<uint64_t>(out, 0); // смещение индекса, заполняется ниже
+
+    std::vector<Entry> placed = entries;
+    for (size_t i = 0; i < placed.size(); ++i) {
+        out.resize((out.size() + kAlignment - 1) / kAlignment * kAlignment, 0);
+        placed[i].offset = out.size();
+        placed[i].size = blobs[i].size();
+        out.insert(out.end(), blobs[i].begin(), blobs[i].end());
+    }
+
+    uint64_t indexOffset = out.size();
+    std::memcpy(out.data() + 12, &indexOffset, sizeof(indexOffset));
+
+    for (const auto& entry : placed) {
+        put<uint32_t>(out, static_cast<uint32_t>(entry.path.size()));
+        out.insert(out.end(), entry.path.begin(), entry.path.end());
+        put<uint8_t>(out, static_cast<uint8_t>(entry.kind));
+        put<uint32_t>(out, entry.width);
+        put<uint32_t>(out, entry.height);
+        put<uint32_t>(out, entry.pitch);
+        put<uint64_t>(out, entry.offset);
+        put<uint64_t>(out, entry.size);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Архив ресурсов assets.pak. Все файлы лежат в одном файле, изображения -
+// уже декодированными в RGBA32, в конце файла находится индекс.
+//
+// Формат (little-endian):
+//   заголовок: "PKPK", u32 версия, u32 число записей, u64 смещение индекса
+//   данные записей, каждая выровнена на 16 байт
+//   индекс: для каждой записи u32 длина пути, путь, u8 тип, u32 ширина,
+//           u32 высота, u32 шаг строки, u64 смещение, u64 размер
+//
+// Во время игры архив отображается в память (mmap), данные ресурсов
+// используются прямо из отображения без копирования.
+class AssetPack {
+public:
+    enum class Kind : uint8_t { RAW = 0, IMAGE_RGBA32 = 1 };
+
+    struct Entry {
+        std::string path;
+        Kind kind = Kind::RAW;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t pitch = 0;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    AssetPack() = default;
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& path);
+    bool isOpen() const { return base != nullptr; }
+
+    const std::vector<Entry>& getEntries() const { return entries; }
+    const Entry* find(const std::string& path) const;
+    const unsigned char* data(const Entry& entry) const { return base + entry.offset; }
+
+    // Используется упаковщиком при сборке
+    static bool write(const std::string& path, const std::vector<Entry>& entries,
+                      const std::vector<std::vector<unsigned char>>& blobs);
+
+private:
+    const unsigned char* base = nullptr;
+    size_t mappedSize = 0;
+    std::vector<unsigned char> fallbackBuffer; // если mmap недоступен
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, size_t> index;
+
+    void close();
+};
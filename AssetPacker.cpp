@@ -0,0 +1,99 @@
+// Упаковщик ресурсов: собирает каталоги ресурсов в один assets.pak.
+// Запускается при сборке (см. CMakeLists.txt):
+//   assetpack <выходной файл> <каталог>...
+// PNG декодируются в RGBA32 заранее, остальные файлы кладутся как есть.
+#include "AssetPack.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+    bool packImage(const std::string& path, AssetPack::Entry& entry, std::vector<unsigned char>& blob) {
+        SDL_Surface* loaded = IMG_Load(path.c_str());
+        if (!loaded) {
+            std::cerr << "assetpack: failed to decode " << path << ": " << IMG_GetError() << std::endl;
+            return false;
+        }
+        SDL_Surface* rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if (!rgba) {
+            std::cerr << "assetpack: failed to convert " << path << ": " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        // Строки пишутся без выравнивания SDL, шаг строки - ровно width * 4
+        entry.kind = AssetPack::Kind::IMAGE_RGBA32;
+        entry.width = rgba->w;
+        entry.height = rgba->h;
+        entry.pitch = rgba->w * 4;
+        blob.resize(static_cast<size_t>(entry.pitch) * entry.height);
+
+        SDL_LockSurface(rgba);
+        for (int y = 0; y < rgba->h; ++y) {
+            std::memcpy(blob.data() + y * entry.pitch,
+                        static_cast<const unsigned char*>(rgba->pixels) + y * rgba->pitch, entry.pitch);
+        }
+        SDL_UnlockSurface(rgba);
+        SDL_FreeSurface(rgba);
+        return true;
+    }
+
+    bool packRaw(const std::string& path, std::vector<unsigned char>& blob) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "assetpack: failed to read " << path << std::endl;
+            return false;
+        }
+        blob.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: assetpack <output.pak> <dir>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i) {
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(argv[i], ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file()) files.push_back(it->path().generic_string());
+        }
+        if (ec) {
+            std::cerr << "assetpack: cannot scan " << argv[i] << ": " << ec.message() << std::endl;
+            return 1;
+        }
+    }
+    // Порядок файлов не зависит от файловой системы - архив воспроизводим
+    std::sort(files.begin(), files.end());
+
+    std::vector<AssetPack::Entry> entries;
+    std::vector<std::vector<unsigned char>> blobs;
+    for (const auto& path : files) {
+        AssetPack::Entry entry;
+        entry.path = path;
+        std::vector<unsigned char> blob;
+
+        bool ok = fs::path(path).extension() == ".png" ? packImage(path, entry, blob) : packRaw(path, blob);
+        if (!ok) return 1;
+
+        entries.push_back(entry);
+        blobs.push_back(std::move(blob));
+    }
+
+    if (!AssetPack::write(argv[1], entries, blobs)) {
+        std::cerr << "assetpack: cannot write " << argv[1] << std::endl;
+        return 1;
+    }
+    std::cout << "assetpack: " << entries.size() << " files -> " << argv[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,392 @@
+#include "Autopilot.h"
+#include "GhostSystem.h"
+#include "JobSystem.h"
+#include "Level.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+    const float kGhostReward = 200.0f;
+    const float kDeathPenalty = -500.0f;
+    // Вес приближения к точкам в оценке конца доигрывания (за клетку).
+    // Без дисконта: иначе на длинных ходах к далёким точкам он тонет в шуме
+    const float kDistanceWeight = 10.0f;
+    // Награда за каждый следующий шаг дешевле: ближняя точка лучше дальней
+    const float kDiscount = 0.97f;
+    // Доля случайных ходов в модели призрака
+    const uint32_t kGhostNoisePercent = 10;
+    // Доля ходов доигрывания в сторону ближайшей точки, остальные случайны
+    const uint32_t kGreedyRolloutPercent = 75;
+
+    inline uint32_t xorshift(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    inline uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline void stepTile(int16_t& x, int16_t& y, Direction dir, int width) {
+        switch (dir) {
+            case Direction::UP:    y--; break;
+            case Direction::DOWN:  y++; break;
+            case Direction::LEFT:  x = static_cast<int16_t>(x == 0 ? width - 1 : x - 1); break;
+            case Direction::RIGHT: x = static_cast<int16_t>(x == width - 1 ? 0 : x + 1); break;
+            case Direction::NONE:  break;
+        }
+    }
+}
+
+Autopilot::Autopilot(const Config& config, JobSystem* jobs) : config(config), jobs(jobs) {
+    workers.resize(jobs ? jobs->getWorkerCount() + 1 : 1);
+}
+
+unsigned Autopilot::exits(int x, int y) const {
+    return exitGrid[y * width + x];
+}
+
+bool Autopilot::isJunction(int x, int y) const {
+    return exitCount(exits(x, y)) >= 3;
+}
+
+Direction Autopilot::decide(const Level& level) {
+    const Pacman* pacman = level.getPacman();
+    if (!pacman || level.getMap().empty()) return Direction::NONE;
+
+    const int x = pacman->getTileX();
+    const int y = pacman->getTileY();
+    const Direction current = pacman->getDirection();
+    const unsigned tileExits = GameObject::exitsAt(x, y, level.getMap());
+    if (x != lastX || y != lastY) {
+        // Пакман ушёл из клетки последнего поиска - решение больше не действует
+        lastX = lastY = -1;
+    }
+
+    // В коридоре выбирать нечего: идём дальше или поворачиваем за угол
+    if (current != Direction::NONE && exitCount(tileExits) < 3) {
+        unsigned forward = tileExits & ~directionBit(oppositeDirection(current));
+        if (forward & directionBit(current)) return Direction::NONE;
+        return forward ? nthExit(forward, 0) : oppositeDirection(current);
+    }
+    // В клетке уже был поиск: повторяем решение, пока Пакман не повернёт,
+    // иначе случайность поиска заставляет его метаться на развилке
+    if (x == lastX && y == lastY) {
+        if (current != lastDecision) return lastDecision;
+        if (tileExits & directionBit(current)) return Direction::NONE;
+    }
+
+    // Клетку могли открыть (дверь загона), поэтому стены берутся заново
+    const std::vector<std::string>& walls = level.getMap();
+    width = level.getGridWidth();
+    height = level.getGridHeight();
+    exitGrid.resize(static_cast<size_t>(width) * height);
+    for (int cy = 0; cy < height; ++cy) {
+        const int rowWidth = static_cast<int>(walls[cy].size());
+        for (int cx = 0; cx < width; ++cx) {
+            // Клетки за концом короткой строки - вне карты
+            exitGrid[cy * width + cx] = cx < rowWidth ? static_cast<uint8_t>(GameObject::exitsAt(cx, cy, walls)) : 0;
+        }
+    }
+
+    SimState root;
+    capture(level, root);
+    computePelletDistance(root.pellets);
+    rootDistance = pelletDistance[y * width + x];
+
+    const uint64_t deadline = nowNs() + static_cast<uint64_t>(config.budgetMs * 1e6);
+    decisionCount++;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].rng = (config.seed ^ (decisionCount * 0x9E3779B9u) ^ (static_cast<uint32_t>(i) * 0x85EBCA6Bu)) | 1u;
+    }
+
+    if (jobs && workers.size() > 1) {
+        jobs->parallelFor(workers.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) search(workers[i], root, deadline);
+        });
+    } else {
+        search(workers[0], root, deadline);
+    }
+
+    // Складываем корневые ходы всех деревьев и берём лучший по средней
+    // оценке: посещения при малом числе итераций почти равны
+    float bestValue = -1.0f;
+    Direction best = Direction::NONE;
+    for (unsigned d = 0; d < 4; ++d) {
+        uint32_t visits = 0;
+        float value = 0.0f;
+        for (const Worker& worker : workers) {
+            visits += worker.rootVisits[d];
+            value += worker.rootValues[d];
+        }
+        if (visits > 0 && value / visits > bestValue) {
+            bestValue = value / visits;
+            best = static_cast<Direction>(d);
+        }
+    }
+    for (const Worker& worker : workers) totalIterations += worker.iterations;
+    lastX = x;
+    lastY = y;
+    lastDecision = best;
+    return best;
+}
+
+void Autopilot::capture(const Level& level, SimState& state) {
+    const Pacman* pacman = level.getPacman();
+    state.pacX = static_cast<int16_t>(pacman->getTileX());
+    state.pacY = static_cast<int16_t>(pacman->getTileY());
+    state.pacDir = pacman->getDirection();
+    state.score = 0.0f;
+    state.steps = 0;
+    state.discount = 1.0f;
+    state.dead = false;
+    state.pellets = level.getPelletGrid();
+
+    // Оставшееся время испуга переводим в шаги Пакмана по клеткам
+    const float tilesPerSecond = static_cast<float>(kPacmanSpeeds.normal) * kTicksPerSecond / toFixed(16);
+    const GhostSystem& ghosts = level.getGhostSystem();
+    float frightenedSeconds = 0.0f;
+    state.ghostCount = static_cast<int>(std::min<size_t>(ghosts.size(), kMaxGhosts));
+    for (int i = 0; i < state.ghostCount; ++i) {
+        SimGhost& ghost = state.ghosts[i];
+        ghost.x = static_cast<int16_t>(ghosts.getTileX(i));
+        ghost.y = static_cast<int16_t>(ghosts.getTileY(i));
+        ghost.dir = ghosts.getDirection(i);
+        ghost.frightened = ghosts.getMode(i) == GhostMode::FRIGHTENED;
+        ghost.chasing = ghosts.getMode(i) == GhostMode::CHASE;
+        ghost.active = ghosts.getIsReleased(i) && !ghosts.getIsEaten(i);
+        if (ghost.frightened) frightenedSeconds = std::max(frightenedSeconds, ghosts.getFrightenedTimer(i));
+    }
+    state.frightenedSteps = static_cast<int>(frightenedSeconds * tilesPerSecond);
+}
+
+void Autopilot::computePelletDistance(const std::vector<uint8_t>& pellets) {
+    // Поиск в ширину сразу от всех точек
+    const int16_t unreachable = static_cast<int16_t>(width + height);
+    pelletDistance.assign(pellets.size(), unreachable);
+    frontier.clear();
+    for (size_t cell = 0; cell < pellets.size(); ++cell) {
+        if (pellets[cell] != PELLET_NONE) {
+            pelletDistance[cell] = 0;
+            frontier.push_back(static_cast<int>(cell));
+        }
+    }
+
+    for (size_t head = 0; head < frontier.size(); ++head) {
+        const int cell = frontier[head];
+        const unsigned moves = exits(cell % width, cell / width);
+        for (int k = 0; k < exitCount(moves); ++k) {
+            int16_t nx = static_cast<int16_t>(cell % width), ny = static_cast<int16_t>(cell / width);
+            stepTile(nx, ny, nthExit(moves, k), width);
+            const int next = ny * width + nx;
+            if (pelletDistance[next] > pelletDistance[cell] + 1) {
+                pelletDistance[next] = static_cast<int16_t>(pelletDistance[cell] + 1);
+                frontier.push_back(next);
+            }
+        }
+    }
+}
+
+void Autopilot::search(Worker& worker, const SimState& root, uint64_t deadlineNs) {
+    std::vector<Node>& nodes = worker.nodes;
+    nodes.clear();
+    nodes.push_back({-1, -1, 0, Direction::NONE, 0, 0.0f});
+    worker.iterations = 0;
+
+    SimState state;
+    while (nowNs() < deadlineNs && (config.maxIterations == 0 || worker.iterations < static_cast<uint64_t>(config.maxIterations))) {
+        state = root; // ёмкость вектора точек переиспользуется
+        int node = 0;
+
+        // Выбор: спуск по UCB1, непосещённые ходы - первыми
+        while (nodes[node].childCount > 0 && !state.dead) {
+            const Node& parent = nodes[node];
+            const float logVisits = std::log(static_cast<float>(parent.visits + 1));
+            int best = parent.firstChild;
+            float bestScore = -1.0f;
+            for (int c = parent.firstChild; c < parent.firstChild + parent.childCount; ++c) {
+                const Node& child = nodes[c];
+                float score = child.visits == 0
+                    ? 1e9f
+                    : child.value / child.visits + config.exploration * std::sqrt(logVisits / child.visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = c;
+                }
+            }
+            advance(state, nodes[best].move, worker.rng);
+            node = best;
+        }
+
+        // Расширение: все выходы из клетки, в которой оказался Пакман
+        if (!state.dead && nodes[node].childCount == 0) {
+            unsigned moves = exits(state.pacX, state.pacY);
+            int count = exitCount(moves);
+            if (count > 0) {
+                nodes[node].firstChild = static_cast<int>(nodes.size());
+                nodes[node].childCount = static_cast<uint8_t>(count);
+                for (int k = 0; k < count; ++k) {
+                    nodes.push_back({node, -1, 0, nthExit(moves, k), 0, 0.0f});
+                }
+                node = nodes[node].firstChild + static_cast<int>(xorshift(worker.rng) % count);
+                advance(state, nodes[node].move, worker.rng);
+            }
+        }
+
+        const float value = normalize(rollout(state, worker.rng));
+
+        for (int n = node; n != -1; n = nodes[n].parent) {
+            nodes[n].visits++;
+            nodes[n].value += value;
+        }
+        worker.iterations++;
+    }
+
+    worker.rootVisits.fill(0);
+    worker.rootValues.fill(0.0f);
+    const Node& rootNode = nodes[0];
+    for (int c = rootNode.firstChild; c >= 0 && c < rootNode.firstChild + rootNode.childCount; ++c) {
+        unsigned d = static_cast<unsigned>(nodes[c].move);
+        worker.rootVisits[d] = nodes[c].visits;
+        worker.rootValues[d] = nodes[c].value;
+    }
+}
+
+void Autopilot::advance(SimState& state, Direction move, uint32_t& rng) const {
+    // Ход - движение до следующей развилки или тупика
+    Direction dir = move;
+    for (int steps = 0; steps < width + height; ++steps) {
+        if (!(exits(state.pacX, state.pacY) & directionBit(dir))) break;
+
+        stepTile(state.pacX, state.pacY, dir, width);
+        state.steps++;
+        state.discount *= kDiscount;
+        uint8_t& pellet = state.pellets[state.pacY * width + state.pacX];
+        const PickupRule& rule = kPickupRules[pellet];
+        state.score += rule.points * state.discount;
+        if (rule.frightensGhosts) {
+            state.frightenedSteps = 20;
+            for (int i = 0; i < state.ghostCount; ++i) {
+                SimGhost& ghost = state.ghosts[i];
+                if (!ghost.active) continue;
+                ghost.frightened = true;
+                ghost.dir = oppositeDirection(ghost.dir);
+            }
+        }
+        pellet = PELLET_NONE;
+
+        checkCollisions(state);
+        if (state.dead) break;
+        stepGhosts(state, rng);
+        checkCollisions(state);
+        if (state.dead) break;
+
+        if (isJunction(state.pacX, state.pacY)) break;
+        unsigned forward = exits(state.pacX, state.pacY) & ~directionBit(oppositeDirection(dir));
+        if (!forward) break;
+        if (!(forward & directionBit(dir))) dir = nthExit(forward, 0);
+    }
+    state.pacDir = dir;
+}
+
+void Autopilot::stepGhosts(SimState& state, uint32_t& rng) const {
+    if (state.frightenedSteps > 0 && --state.frightenedSteps == 0) {
+        for (int i = 0; i < state.ghostCount; ++i) state.ghosts[i].frightened = false;
+    }
+
+    for (int i = 0; i < state.ghostCount; ++i) {
+        SimGhost& ghost = state.ghosts[i];
+        if (!ghost.active) continue;
+        // Испуганный призрак вдвое медленнее, обычный пропускает каждый
+        // шестнадцатый шаг (75% скорости против 80% у Пакмана)
+        if (ghost.frightened && (state.frightenedSteps & 1)) continue;
+        if (!ghost.frightened && (state.steps & 15) == 15) continue;
+
+        unsigned options = exits(ghost.x, ghost.y);
+        unsigned forward = options & ~directionBit(oppositeDirection(ghost.dir));
+        options = forward ? forward : options;
+        if (!options) continue;
+
+        // Разбегающийся призрак идёт к своему углу, а не к Пакману: в
+        // модели он блуждает, иначе Пакман шарахается от далёких призраков
+        if (ghost.frightened || !ghost.chasing || xorshift(rng) % 100 < kGhostNoisePercent) {
+            ghost.dir = nthExit(options, xorshift(rng) % exitCount(options));
+        } else {
+            // Жадно к Пакману по манхэттенскому расстоянию
+            int bestDistance = INT32_MAX;
+            for (int k = 0; k < exitCount(options); ++k) {
+                Direction dir = nthExit(options, k);
+                int16_t nx = ghost.x, ny = ghost.y;
+                stepTile(nx, ny, dir, width);
+                int distance = std::abs(nx - state.pacX) + std::abs(ny - state.pacY);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    ghost.dir = dir;
+                }
+            }
+        }
+        stepTile(ghost.x, ghost.y, ghost.dir, width);
+    }
+}
+
+void Autopilot::checkCollisions(SimState& state) const {
+    for (int i = 0; i < state.ghostCount; ++i) {
+        SimGhost& ghost = state.ghosts[i];
+        if (!ghost.active || ghost.x != state.pacX || ghost.y != state.pacY) continue;
+        if (ghost.frightened) {
+            ghost.active = false;
+            state.score += kGhostReward * state.discount;
+        } else {
+            state.dead = true;
+            state.score += kDeathPenalty * state.discount;
+            return;
+        }
+    }
+}
+
+float Autopilot::rollout(SimState& state, uint32_t& rng) const {
+    // Доигрывание без разворотов: чаще к ближайшей точке, иначе случайно.
+    // Чисто случайные ходы редко доходят до далёких точек, и оценки
+    // корневых ходов почти не различаются
+    int16_t lastX = -1, lastY = -1;
+    for (int moves = 0; moves < config.rolloutMoves && !state.dead; ++moves) {
+        unsigned options = exits(state.pacX, state.pacY);
+        unsigned forward = options & ~directionBit(oppositeDirection(state.pacDir));
+        options = forward ? forward : options;
+        if (!options) break;
+
+        Direction move = nthExit(options, xorshift(rng) % exitCount(options));
+        if (xorshift(rng) % 100 < kGreedyRolloutPercent) {
+            int bestDistance = INT32_MAX;
+            for (int k = 0; k < exitCount(options); ++k) {
+                Direction dir = nthExit(options, k);
+                int16_t nx = state.pacX, ny = state.pacY;
+                stepTile(nx, ny, dir, width);
+                int distance = pelletDistance[ny * width + nx];
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    move = dir;
+                }
+            }
+        }
+        advance(state, move, rng);
+        if (state.pacX == lastX && state.pacY == lastY) break; // упёрлись
+        lastX = state.pacX;
+        lastY = state.pacY;
+    }
+    if (!state.dead) {
+        const int distance = pelletDistance[state.pacY * width + state.pacX];
+        state.score += kDistanceWeight * (rootDistance - distance);
+    }
+    return state.score;
+}
+
+float Autopilot::normalize(float score) const {
+    return std::min(1.0f, std::max(0.0f, (score - kDeathPenalty) / 1000.0f));
+}
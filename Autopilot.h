@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Characters.h"
+
+class Level;
+class JobSystem;
+
+// Автопилот Пакмана на поиске по дереву Монте-Карло (MCTS). Решение
+// принимается только на развилках: в коридоре Пакман просто идёт по нему.
+//
+// Поиск идёт не по копиям Level, а по компактному снимку уровня с шагом в
+// одну клетку: стены и точки - сеткой, призраки двигаются по дешёвой модели
+// (жадно к Пакману, в испуге - случайно). Ход в дереве - направление на
+// развилке и движение до следующей развилки. Каждый поток строит своё
+// дерево от одного корня, посещения корневых ходов складываются.
+class Autopilot {
+public:
+    struct Config {
+        double budgetMs = 8.0;     // время на одно решение
+        int maxIterations = 0;     // 0 - без ограничения, только по времени
+        int rolloutMoves = 20;     // длина случайного доигрывания в ходах
+        float exploration = 0.1f;  // константа UCB1
+        uint32_t seed = 1;
+    };
+
+    explicit Autopilot(const Config& config, JobSystem* jobs = nullptr);
+
+    // Направление для Pacman::setNextDirection или NONE, если менять нечего
+    Direction decide(const Level& level);
+    void setBudget(double budgetMs) { config.budgetMs = budgetMs; }
+
+    uint64_t getTotalIterations() const { return totalIterations; }
+
+private:
+    static const int kMaxGhosts = 8;
+
+    struct SimGhost {
+        int16_t x, y;
+        Direction dir;
+        bool frightened;
+        bool chasing;  // преследует, а не разбегается по углам
+        bool active;  // выпущен и не съеден
+    };
+
+    // Снимок уровня для доигрываний
+    struct SimState {
+        int16_t pacX, pacY;
+        Direction pacDir;
+        int frightenedSteps;
+        int steps;
+        int ghostCount;
+        std::array<SimGhost, kMaxGhosts> ghosts;
+        float score;
+        float discount;
+        bool dead;
+        std::vector<uint8_t> pellets;
+    };
+
+    struct Node {
+        int parent;
+        int firstChild;
+        uint8_t childCount;
+        Direction move;
+        uint32_t visits;
+        float value;
+    };
+
+    struct Worker {
+        std::vector<Node> nodes;
+        uint32_t rng;
+        uint64_t iterations;
+        std::array<uint32_t, 4> rootVisits;
+        std::array<float, 4> rootValues;
+    };
+
+    Config config;
+    JobSystem* jobs;
+    std::vector<Worker> workers;
+    uint64_t totalIterations = 0;
+    uint32_t decisionCount = 0;
+    // Клетка и результат последнего поиска
+    int lastX = -1;
+    int lastY = -1;
+    Direction lastDecision = Direction::NONE;
+
+    // Маски выходов клеток на момент решения, общие для всех потоков
+    std::vector<uint8_t> exitGrid;
+    int width = 0;
+    int height = 0;
+    // Расстояние в клетках до ближайшей точки на момент решения: им
+    // оценивается конец доигрывания, когда рядом точек не осталось
+    std::vector<int16_t> pelletDistance;
+    int rootDistance = 0;
+    std::vector<int> frontier;
+
+    void computePelletDistance(const std::vector<uint8_t>& pellets);
+
+    void capture(const Level& level, SimState& state);
+    void search(Worker& worker, const SimState& root, uint64_t deadlineNs);
+    unsigned exits(int x, int y) const;
+    bool isJunction(int x, int y) const;
+    void advance(SimState& state, Direction move, uint32_t& rng) const;
+    void stepGhosts(SimState& state, uint32_t& rng) const;
+    void checkCollisions(SimState& state) const;
+    float rollout(SimState& state, uint32_t& rng) const;
+    float normalize(float score) const;
+};
@@ -1,46 +1,88 @@
 #include "BaseMenu.h"
-#include <SDL2/SDL_ttf.h>
 #include <iostream>
 
-BaseMenu::BaseMenu(SDL_Renderer* renderer) : renderer(renderer) {}
+BaseMenu::BaseMenu(SDL_Renderer* renderer) : renderer(renderer) {
+    font = TTF_OpenFont("fonts/arial.ttf", 24);
+    if (!font) {
+        std::cerr << "TTF_OpenFont Error: " << TTF_GetError() << std::endl;
+    }
+}
+
+BaseMenu::~BaseMenu() {
+    releaseLabels();
+    if (font) {
+        TTF_CloseFont(font);
+        font = nullptr;
+    }
+}
+
+SDL_Texture* BaseMenu::prerenderLabel(const std::string& text) {
+    if (!font || text.empty()) return nullptr;
+
+    SDL_Color textColor = {255, 255, 255, 255};
+    SDL_Surface* textSurface = TTF_RenderText_Blended(font, text.c_str(), textColor);
+    if (!textSurface) {
+        std::cerr << "TTF_RenderText Error: " << TTF_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+    SDL_FreeSurface(textSurface);
+    if (textTexture) labels.push_back(textTexture);
+    return textTexture;
+}
+
+void BaseMenu::releaseLabels() {
+    for (SDL_Texture* label : labels) {
+        SDL_DestroyTexture(label);
+    }
+    labels.clear();
+    for (auto& button : buttons) {
+        button.label = nullptr;
+    }
+}
 
 void BaseMenu::addButton(const Button& button) {
     buttons.push_back(button);
+    if (!buttons.back().label) {
+        buttons.back().label = prerenderLabel(button.text);
+    }
 }
 
 const std::vector<Button>& BaseMenu::getButtons() const {
     return buttons;
 }
 
+bool BaseMenu::updateHover(int x, int y) {
+    bool changed = false;
+    for (auto& button : buttons) {
+        bool hover = button.contains(x, y);
+        if (hover != button.isHovered) {
+            button.setHovered(hover);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 void BaseMenu::render() {
     SDL_SetRenderDrawColor(renderer, bg_color.r, bg_color.g, bg_color.b, bg_color.a);
     SDL_RenderFillRect(renderer, nullptr);
 
-    const char* fontPath = "fonts/arial.ttf";
-
-    TTF_Font* font = TTF_OpenFont(fontPath, 24);
-    if (!font) {
-        std::cerr << "TTF_OpenFont Error: " << TTF_GetError() << std::endl;
-        return;
-    }
-
-    SDL_Color textColor = {255, 255, 255, 255};
-
     for (const auto& button : buttons) {
-        SDL_SetRenderDrawColor(renderer, button.color.r, button.color.g, button.color.b, 255);
-        SDL_RenderFillRect(renderer, &button.rect);
-
-        SDL_Surface* textSurface = TTF_RenderText_Blended(font, button.text.c_str(), textColor);
-        if (!textSurface) {
-            std::cerr << "TTF_RenderText Error: " << TTF_GetError() << std::endl;
-            continue;
+        SDL_Color color = button.color;
+        if (button.isHovered) {
+            color.r = static_cast<Uint8>(color.r + (255 - color.r) / 3);
+            color.g = static_cast<Uint8>(color.g + (255 - color.g) / 3);
+            color.b = static_cast<Uint8>(color.b + (255 - color.b) / 3);
         }
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+        SDL_RenderFillRect(renderer, &button.rect);
 
-        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        SDL_FreeSurface(textSurface);
+        if (!button.label) continue;
 
         int textWidth, textHeight;
-        SDL_QueryTexture(textTexture, nullptr, nullptr, &textWidth, &textHeight);
+        SDL_QueryTexture(button.label, nullptr, nullptr, &textWidth, &textHeight);
         SDL_Rect textRect = {
             button.rect.x + (button.rect.w - textWidth)/2,
             button.rect.y + (button.rect.h - textHeight)/2,
@@ -48,9 +90,6 @@ void BaseMenu::render() {
             textHeight
         };
 
-        SDL_RenderCopy(renderer, textTexture, nullptr, &textRect);
-        SDL_DestroyTexture(textTexture);
+        SDL_RenderCopy(renderer, button.label, nullptr, &textRect);
     }
-
-    TTF_CloseFont(font);
-}
\ No newline at end of file
+}
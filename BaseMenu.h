@@ -1,17 +1,31 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
 #include <vector>
 #include "Button.h"
 
 class BaseMenu {
 protected:
     SDL_Renderer* renderer;
+    TTF_Font* font = nullptr;
     std::vector<Button> buttons;
+    std::vector<SDL_Texture*> labels; // все надписи, созданные меню
     SDL_Color bg_color = {30, 30, 30, 255};
+
+    SDL_Texture* prerenderLabel(const std::string& text);
+    void releaseLabels();
     
 public:
     explicit BaseMenu(SDL_Renderer* renderer);
+    virtual ~BaseMenu();
+    BaseMenu(const BaseMenu&) = delete;
+    BaseMenu& operator=(const BaseMenu&) = delete;
+
     void addButton(const Button& button);
     const std::vector<Button>& getButtons() const;
+    // Подсветка кнопки под курсором. true - подсветка изменилась и меню
+    // нужно перерисовать
+    bool updateHover(int x, int y);
     void render();
-};
\ No newline at end of file
+};
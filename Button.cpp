@@ -1,10 +1,15 @@
 #include "Button.h"
 #include <SDL2/SDL.h>
 
-Button::Button() : rect{0, 0, 0, 0}, text(""), action(""), target(""), color{0, 0, 0}, isHovered(false) {}
+Button::Button() : rect{0, 0, 0, 0}, text(""), action(MenuAction::NONE), target(""), targetScreen(-1),
+                   color{0, 0, 0}, isHovered(false), label(nullptr) {}
 
-Button::Button(SDL_Rect r, std::string t, std::string a, std::string tar, SDL_Color c) 
-    : rect(r), text(t), action(a), target(tar), color(c), isHovered(false) {}
+Button::Button(SDL_Rect r, std::string t, MenuAction a, std::string tar, SDL_Color c) 
+    : rect(r), text(t), action(a), target(tar), targetScreen(-1), color(c), isHovered(false), label(nullptr) {}
+
+Button::Button(const MenuButtonDef& def)
+    : rect(def.rect), text(def.text), action(def.action), target(def.target), targetScreen(def.targetScreen),
+      color(def.color), isHovered(false), label(nullptr) {}
 
 bool Button::contains(int x, int y) const {
     return (x >= rect.x && x <= rect.x + rect.w &&
@@ -13,4 +18,4 @@ bool Button::contains(int x, int y) const {
 
 void Button::setHovered(bool hover) {
     isHovered = hover;
-}
\ No newline at end of file
+}
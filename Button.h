@@ -1,18 +1,22 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <string>
+#include "MenuConfig.h"
 
 struct Button {
     SDL_Rect rect;
     std::string text;
-    std::string action;
+    MenuAction action;
     std::string target;
+    int targetScreen;
     SDL_Color color;
     bool isHovered;
+    SDL_Texture* label; // заранее отрисованная надпись, владелец - меню
     
     Button();
-    Button(SDL_Rect r, std::string t, std::string a, std::string tar, SDL_Color c);
+    Button(SDL_Rect r, std::string t, MenuAction a, std::string tar, SDL_Color c);
+    explicit Button(const MenuButtonDef& def);
     
     bool contains(int x, int y) const;
     void setHovered(bool hover);
-};
\ No newline at end of file
+};
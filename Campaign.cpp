@@ -0,0 +1,89 @@
+#include "Campaign.h"
+#include "AssetManager.h"
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+    FruitType parseFruit(const std::string& fruitName) {
+        static const std::pair<const char*, FruitType> names[] = {
+            {"cherry", FruitType::CHERRY}, {"strawberry", FruitType::STRAWBERRY},
+            {"orange", FruitType::ORANGE}, {"apple", FruitType::APPLE},
+            {"melon", FruitType::MELON}, {"boss", FruitType::BOSS},
+            {"bell", FruitType::BELL}, {"key", FruitType::KEY},
+        };
+        for (const auto& entry : names) {
+            if (fruitName == entry.first) return entry.second;
+        }
+        throw std::runtime_error("unknown fruit: " + fruitName);
+    }
+}
+
+Campaign::~Campaign() {
+    if (loader.joinable()) loader.join();
+}
+
+bool Campaign::isManifest(const std::string& path) {
+    return path.size() > 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+}
+
+bool Campaign::load(const std::string& path, AssetManager& assetManager) {
+    if (loader.joinable()) loader.join();
+    preloaded.reset();
+    assets = &assetManager;
+    entries.clear();
+
+    std::string text;
+    if (!assets->readText(path, text)) {
+        std::cerr << "Failed to open campaign " << path << std::endl;
+        return false;
+    }
+    try {
+        json root = json::parse(text);
+        name = root.value("name", path);
+        for (const auto& item : root.at("levels")) {
+            Entry entry;
+            entry.map = item.at("map").get<std::string>();
+            entry.rules.speedPercent = item.value("speed", 100);
+            entry.rules.frightenedSeconds = item.value("frightened", 5.0f);
+            for (const auto& fruit : item.value("fruits", json::array())) {
+                entry.rules.fruits.push_back(parseFruit(fruit.get<std::string>()));
+            }
+            if (entry.rules.speedPercent <= 0 || entry.rules.frightenedSeconds < 0) {
+                throw std::runtime_error("bad speed or frightened time for " + entry.map);
+            }
+            entries.push_back(entry);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to parse campaign " << path << ": " << e.what() << std::endl;
+        entries.clear();
+        return false;
+    }
+    if (entries.empty()) {
+        std::cerr << "Campaign " << path << " has no levels" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Level> Campaign::build(size_t index) const {
+    const Entry& entry = entries[index];
+    auto level = std::make_unique<Level>(nullptr, *assets);
+    if (!level->loadFromFile(entry.map)) return nullptr;
+    level->setRules(entry.rules);
+    return level;
+}
+
+void Campaign::preload(size_t index) {
+    if (loader.joinable()) loader.join();
+    preloaded.reset();
+    // readText можно звать из любого потока: декодирование ресурса
+    // захватывается атомарно, а текстур у assets без рендерера нет
+    loader = std::thread([this, index] { preloaded = build(index); });
+}
+
+std::unique_ptr<Level> Campaign::takePreloaded() {
+    if (loader.joinable()) loader.join();
+    return std::move(preloaded);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Level.h"
+
+class AssetManager;
+
+// Кампания - список уровней из манифеста (levels/campaign.json):
+//   {"name": "...", "levels": [{"map": "levels/level1.txt", "speed": 100,
+//                               "frightened": 5.0, "fruits": ["cherry"]}, ...]}
+// Пока идёт текущий уровень, следующий читается, разбирается и строится в
+// фоновом потоке, так что смена уровня в конце раунда - обмен указателей.
+class Campaign {
+public:
+    struct Entry {
+        std::string map;
+        LevelRules rules;
+    };
+
+    Campaign() = default;
+    ~Campaign();
+    Campaign(const Campaign&) = delete;
+    Campaign& operator=(const Campaign&) = delete;
+
+    static bool isManifest(const std::string& path);
+
+    // assets - без рендерера, уровни строятся для потока симуляции
+    bool load(const std::string& path, AssetManager& assets);
+    size_t size() const { return entries.size(); }
+    const Entry& getEntry(size_t index) const { return entries[index]; }
+    const std::string& getName() const { return name; }
+
+    // Уровень index, собранный в вызывающем потоке; nullptr - ошибка
+    std::unique_ptr<Level> build(size_t index) const;
+    // Начинает собирать уровень index в фоновом потоке
+    void preload(size_t index);
+    // Уровень из preload; если он ещё строится - ждёт. nullptr - ошибка
+    std::unique_ptr<Level> takePreloaded();
+
+private:
+    AssetManager* assets = nullptr;
+    std::string name;
+    std::vector<Entry> entries;
+
+    std::thread loader;
+    std::unique_ptr<Level> preloaded;  // пишет loader, читается после join
+};
@@ -1,4 +1,6 @@
 #include "Characters.h"
+#include "AssetManager.h"
+#include "GhostSystem.h"
 #include <SDL2/SDL_image.h>
 #include <algorithm>
 #include <cstdlib>
@@ -8,18 +10,21 @@
 // GameObject
 GameObject::GameObject(int x, int y) : 
     tileX(x), tileY(y),
-    pixelX(x * 16 + 8), pixelY(y * 16 + 8),
-    hitbox{pixelX - 8, pixelY - 8, 16, 16},
+    posX(tileCenterFixed(x)), posY(tileCenterFixed(y)),
+    hitbox{x * 16, y * 16, 16, 16},
     isActive(true),
     currentDir(Direction::NONE),
     nextDir(Direction::NONE),
+    nextDirTicks(0),
     texture(nullptr) {}
 
-GameObject::~GameObject() {
-    if (texture) SDL_DestroyTexture(texture);
-}
+GameObject::~GameObject() {}
 
 bool GameObject::canMove(Direction dir, const std::vector<std::string>& levelMap) const {
+    return canMoveFrom(tileX, tileY, dir, levelMap);
+}
+
+bool GameObject::canMoveFrom(int tileX, int tileY, Direction dir, const std::vector<std::string>& levelMap) {
     if (dir == Direction::NONE) return false;
 
     // Текущие координаты в тайлах
@@ -42,101 +47,170 @@ bool GameObject::canMove(Direction dir, const std::vector<std::string>& levelMap
         return false;
     }
 
+    // Строки карты могут быть разной длины (её правят во время игры):
+    // за концом строки хода нет
+    if (checkX >= static_cast<int>(levelMap[checkY].size())) return false;
+
     // Проверка стены
     return levelMap[checkY][checkX] != '#';
 }
 
-void GameObject::move(float deltaTime, const std::vector<std::string>& levelMap) {
-    const float speed = 70.0f * deltaTime;
-    
-    // Проверяем смену направления только когда объект в центре тайла
-    if (nextDir != Direction::NONE && 
-        abs(pixelX - (tileX * 16 + 8)) < 2.0f && 
-        abs(pixelY - (tileY * 16 + 8)) < 2.0f) {
-        if (canMove(nextDir, levelMap)) {
-            currentDir = nextDir;
-            nextDir = Direction::NONE;
-        }
+unsigned GameObject::getExits(const std::vector<std::string>& levelMap) const {
+    return exitsAt(tileX, tileY, levelMap);
+}
+
+unsigned GameObject::exitsAt(int tileX, int tileY, const std::vector<std::string>& levelMap) {
+    return (canMoveFrom(tileX, tileY, Direction::UP, levelMap)    ? directionBit(Direction::UP)    : 0u) |
+           (canMoveFrom(tileX, tileY, Direction::RIGHT, levelMap) ? directionBit(Direction::RIGHT) : 0u) |
+           (canMoveFrom(tileX, tileY, Direction::DOWN, levelMap)  ? directionBit(Direction::DOWN)  : 0u) |
+           (canMoveFrom(tileX, tileY, Direction::LEFT, levelMap)  ? directionBit(Direction::LEFT)  : 0u);
+}
+
+void GameObject::setNextDirection(Direction dir) {
+    nextDir = dir;
+    nextDirTicks = dir == Direction::NONE ? 0 : kTurnBufferTicks;
+}
+
+void GameObject::applyBufferedTurn(const std::vector<std::string>& levelMap) {
+    if (nextDir == Direction::NONE) return;
+
+    // Разворот на месте разрешён всегда
+    if (nextDir == oppositeDirection(currentDir) || nextDir == currentDir) {
+        currentDir = nextDir;
+        nextDir = Direction::NONE;
+        return;
     }
 
+    // Поворот - только рядом с центром тайла и если в маске выходов есть
+    // нужное направление. Оставшееся смещение убирается в move (срез угла)
+    bool vertical = currentDir == Direction::UP || currentDir == Direction::DOWN;
+    Fixed offset = vertical ? posY - tileCenterFixed(tileY) : posX - tileCenterFixed(tileX);
+    if (currentDir != Direction::NONE && abs(offset) > toFixed(kCornerWindow)) return;
+
+    if (getExits(levelMap) & directionBit(nextDir)) {
+        currentDir = nextDir;
+        nextDir = Direction::NONE;
+    }
+}
+
+bool GameObject::isTunnelTile(int tileX, int tileY, const std::vector<std::string>& levelMap) {
+    if (tileY < 0 || tileY >= static_cast<int>(levelMap.size())) return false;
+
+    // Туннель - пустые клетки от открытого края строки до первой точки или стены
+    const std::string& row = levelMap[tileY];
+    if (row.empty() || row.front() == '#' || row.back() == '#') return false;
+    size_t left = row.find_first_not_of(' ');
+    size_t right = row.find_last_not_of(' ');
+    return static_cast<size_t>(tileX) < left || (right != std::string::npos && static_cast<size_t>(tileX) > right);
+}
+
+void GameObject::move(const std::vector<std::string>& levelMap) {
+    // Буфер поворота живёт фиксированное число тиков (один вызов move - один тик)
+    applyBufferedTurn(levelMap);
+    if (nextDir != Direction::NONE && --nextDirTicks <= 0) {
+        nextDir = Direction::NONE;
+    }
+
+    const Fixed speed = tickSpeed(levelMap);
+    const Fixed centerX = tileCenterFixed(tileX);
+    const Fixed centerY = tileCenterFixed(tileY);
+    const Fixed mapWidth = toFixed(static_cast<int>(levelMap[0].size()) * 16);
+
+    // Срез угла: после раннего поворота смещение по старой оси
+    // убирается с той же скоростью, объект движется по диагонали
+    if (currentDir == Direction::UP || currentDir == Direction::DOWN) {
+        posX += std::max(-speed, std::min(speed, centerX - posX));
+    } else if (currentDir == Direction::LEFT || currentDir == Direction::RIGHT) {
+        posY += std::max(-speed, std::min(speed, centerY - posY));
+    }
+
+    // Перед стеной объект доходит до центра тайла и останавливается
     switch(currentDir) {
         case Direction::UP:
-            pixelY -= speed/2;
-            if (canMove(Direction::UP, levelMap)) {
-                tileY = pixelY / 16;
-            } else {
-                pixelY = tileY * 16 + 8; 
-            }
+            posY -= speed;
+            if (!canMove(Direction::UP, levelMap)) posY = std::max(posY, centerY);
             break;
-            
+
         case Direction::DOWN:
-            pixelY += speed;
-            if (canMove(Direction::DOWN, levelMap)) {
-                tileY = pixelY / 16;
-            } else {
-                pixelY = tileY * 16 + 8;
-            }
+            posY += speed;
+            if (!canMove(Direction::DOWN, levelMap)) posY = std::min(posY, centerY);
             break;
-            
+
         case Direction::LEFT:
-            pixelX -= speed/2;
-            if (canMove(Direction::LEFT, levelMap)) {
-                if (pixelX < 0) pixelX = (levelMap[0].size() - 1) * 16 + 8; // Туннель
-                tileX = pixelX / 16;
-            } else {
-                pixelX = tileX * 16 + 8;
-            }
+            posX -= speed;
+            if (!canMove(Direction::LEFT, levelMap)) posX = std::max(posX, centerX);
+            else if (posX < 0) posX += mapWidth; // Туннель
             break;
-            
+
         case Direction::RIGHT:
-            pixelX += speed;
-            if (canMove(Direction::RIGHT, levelMap)) {
-                if (pixelX >= levelMap[0].size() * 16) pixelX = 8; // Туннель
-                tileX = pixelX / 16;
-            } else {
-                pixelX = tileX * 16 + 8;
-            }
+            posX += speed;
+            if (!canMove(Direction::RIGHT, levelMap)) posX = std::min(posX, centerX);
+            else if (posX >= mapWidth) posX -= mapWidth; // Туннель
             break;
-            
+
         case Direction::NONE:
             break;
     }
 
-    if (abs(pixelX - (tileX * 16 + 8)) >= 16 || abs(pixelY - (tileY * 16 + 8)) >= 16) {
-        tileX = static_cast<int>((pixelX) / 16);
-        tileY = static_cast<int>((pixelY) / 16);
-    }
-
-    hitbox.x = pixelX-8;
-    hitbox.y = pixelY-8;
+    tileX = getPixelX() / 16;
+    tileY = getPixelY() / 16;
+    hitbox.x = getPixelX() - 8;
+    hitbox.y = getPixelY() - 8;
 }
 
 void GameObject::setPosition(int tileX, int tileY) {
         this->tileX = tileX;
         this->tileY = tileY;
-        this->pixelX = tileX * 16 + 8;
-        this->pixelY = tileY * 16 + 8;
-        this->hitbox.x = pixelX - 8;
-        this->hitbox.y = pixelY - 8;
+        this->posX = tileCenterFixed(tileX);
+        this->posY = tileCenterFixed(tileY);
+        this->hitbox.x = getPixelX() - 8;
+        this->hitbox.y = getPixelY() - 8;
         this->currentDir = Direction::NONE;
         this->nextDir = Direction::NONE;
 }
 
+void GameObject::saveMotion(std::vector<uint8_t>& out) const {
+    putSigned(out, tileX);
+    putSigned(out, tileY);
+    putSigned(out, posX);
+    putSigned(out, posY);
+    putSigned(out, hitbox.x);
+    putSigned(out, hitbox.y);
+    out.push_back(isActive ? 1 : 0);
+    out.push_back(static_cast<uint8_t>(currentDir));
+    out.push_back(static_cast<uint8_t>(nextDir));
+    putSigned(out, nextDirTicks);
+}
+
+bool GameObject::restoreMotion(ByteReader& in) {
+    uint8_t active, current, next;
+    if (!in.signedVarint(tileX) || !in.signedVarint(tileY) || !in.signedVarint(posX) || !in.signedVarint(posY) ||
+        !in.signedVarint(hitbox.x) || !in.signedVarint(hitbox.y) ||
+        !in.byte(active) || !in.byte(current) || !in.byte(next) || !in.signedVarint(nextDirTicks)) {
+        return false;
+    }
+    if (current > static_cast<uint8_t>(Direction::NONE) || next > static_cast<uint8_t>(Direction::NONE)) return false;
+    isActive = active != 0;
+    currentDir = static_cast<Direction>(current);
+    nextDir = static_cast<Direction>(next);
+    return true;
+}
+
 // Pacman
-Pacman::Pacman(int x, int y, SDL_Renderer* renderer) : 
+Pacman::Pacman(int x, int y, SDL_Renderer* renderer, AssetManager& assets) : 
     GameObject(x, y), mouthOpen(false), animTimer(0),
     lives(3), score(0), isPowered(false) {
-    textureOpen = IMG_LoadTexture(renderer, "sprites/pacman/1.png");
-    textureClosed = IMG_LoadTexture(renderer, "sprites/pacman/2.png");
-    if (!textureOpen || !textureClosed) {
-        std::cerr << "Failed to load Pacman textures: " << IMG_GetError() << std::endl;
-    }
+    textureOpen = assets.getTexture("sprites/pacman/1.png", renderer);
+    textureClosed = assets.getTexture("sprites/pacman/2.png", renderer);
 }
 
 Pacman::~Pacman() {
     std::cout << "Pacman destroyed!" << std::endl;
-    SDL_DestroyTexture(textureOpen);
-    SDL_DestroyTexture(textureClosed);
+}
+
+Fixed Pacman::tickSpeed(const std::vector<std::string>& levelMap) const {
+    if (isPowered) return speeds.frightened;
+    return isTunnelTile(tileX, tileY, levelMap) ? speeds.tunnel : speeds.normal;
 }
 
 void Pacman::update(float deltaTime) {
@@ -147,6 +221,25 @@ void Pacman::update(float deltaTime) {
     }
 }
 
+void Pacman::saveState(std::vector<uint8_t>& out) const {
+    saveMotion(out);
+    out.push_back(static_cast<uint8_t>((mouthOpen ? 1 : 0) | (isPowered ? 2 : 0)));
+    putFloat(out, animTimer);
+    putSigned(out, lives);
+    putSigned(out, score);
+}
+
+bool Pacman::restoreState(ByteReader& in) {
+    uint8_t flags;
+    if (!restoreMotion(in) || !in.byte(flags) || !in.floatValue(animTimer) ||
+        !in.signedVarint(lives) || !in.signedVarint(score)) {
+        return false;
+    }
+    mouthOpen = (flags & 1) != 0;
+    isPowered = (flags & 2) != 0;
+    return true;
+}
+
 void Pacman::render(SDL_Renderer* renderer) {
     SDL_Texture* tex = mouthOpen ? textureOpen : textureClosed;
     
@@ -175,155 +268,37 @@ void Pacman::handleInput(const SDL_Event& event) {
 }
 
 // Ghost
-Ghost::Ghost(int x, int y, SDL_Renderer* renderer) : 
-    GameObject(x, y), isReleased(false), releaseTimer(0.0f), 
-    modeSwitchTimer(0.0f), isInChaseMode(true) 
-{
-    textureNormal = IMG_LoadTexture(renderer, "sprites/ghosts/b-0.png");
-    textureFrightened = IMG_LoadTexture(renderer, "sprites/ghosts/f-0.png");
-    
-    if (!textureNormal || !textureFrightened) {
-        std::cerr << "Failed to load ghost textures: " << IMG_GetError() << std::endl;
-    }
+Ghost::Ghost(int x, int y, SDL_Renderer* renderer, AssetManager& assets) : GameObject(x, y) {
+    textureNormal = assets.getTexture("sprites/ghosts/b-0.png", renderer);
+    textureFrightened = assets.getTexture("sprites/ghosts/f-0.png", renderer);
 
     setIsActive(true);
     currentDir = Direction::UP;
-    mode = GhostMode::SCATTER;
-    modeTimer = 5.0f;
-}
-
-Ghost::~Ghost() {
-    SDL_DestroyTexture(textureNormal);
-    SDL_DestroyTexture(textureFrightened);
 }
 
-void Ghost::update(float deltaTime, const Pacman* pacman, std::vector<std::string>& levelMap) {
-    if (isEaten) return;
+Ghost::~Ghost() {}
 
-    if (!isReleased) {
-        releaseTimer += deltaTime;
-        if (releaseTimer >= 5.0f) {
-            // Открываем клетку
-            if (levelMap.size() > 9 && levelMap[9].size() > 9) {
-                levelMap[9][9] = ' ';
-            }
-            isReleased = true;
-            mode = GhostMode::SCATTER;
-            modeTimer = 7.0f;
-        }
-        return;
-    }
-
-    if (mode != GhostMode::FRIGHTENED) {
-        modeTimer -= deltaTime;
-        if (modeTimer <= 0) {
-            mode = (mode == GhostMode::CHASE) ? GhostMode::SCATTER : GhostMode::CHASE;
-            modeTimer = 5.0f; 
-
-            // Разворачиваем призрака при смене режима
-            switch(currentDir) {
-                case Direction::UP: currentDir = Direction::DOWN; break;
-                case Direction::DOWN: currentDir = Direction::UP; break;
-                case Direction::LEFT: currentDir = Direction::RIGHT; break;
-                case Direction::RIGHT: currentDir = Direction::LEFT; break;
-            }
-        }
-    }
-
-    // Обработка режима испуга
-    if (mode == GhostMode::FRIGHTENED) {
-        frightenedTimer -= deltaTime;
-        if (frightenedTimer <= 0) {
-            setFrightened(false);
-            modeTimer = 5.0f;
-        }
-        if (rand() % 100 < 5) {
-            std::vector<Direction> possibleDirs;
-            if (canMove(Direction::UP, levelMap)) possibleDirs.push_back(Direction::UP);
-            if (canMove(Direction::DOWN, levelMap)) possibleDirs.push_back(Direction::DOWN);
-            if (canMove(Direction::LEFT, levelMap)) possibleDirs.push_back(Direction::LEFT);
-            if (canMove(Direction::RIGHT, levelMap)) possibleDirs.push_back(Direction::RIGHT);
-            
-            if (!possibleDirs.empty()) {
-                currentDir = possibleDirs[rand() % possibleDirs.size()];
-            }
-        }
-    }
-    else {
-        updateAI(pacman, levelMap);
-    }
-
-    move(deltaTime, levelMap);
+void Ghost::attach(GhostSystem* ghostSystem, size_t ghostIndex) {
+    system = ghostSystem;
+    index = ghostIndex;
+    syncFromSystem();
 }
 
-void Ghost::updateAI(const Pacman* pacman, const std::vector<std::string>& levelMap) {
-    if (!pacman) return;
-
-    int targetTileX, targetTileY;
-    
-    if (mode == GhostMode::CHASE) {
-        targetTileX = pacman->getTileX();
-        targetTileY = pacman->getTileY();
-    } 
-    else { // SCATTER 
-        targetTileX = 1;
-        targetTileY = 1;
-    }
-
-    std::vector<Direction> possibleDirs;
-    if (canMove(Direction::UP, levelMap)) possibleDirs.push_back(Direction::UP);
-    if (canMove(Direction::DOWN, levelMap)) possibleDirs.push_back(Direction::DOWN);
-    if (canMove(Direction::LEFT, levelMap)) possibleDirs.push_back(Direction::LEFT);
-    if (canMove(Direction::RIGHT, levelMap)) possibleDirs.push_back(Direction::RIGHT);
-
-    // Удаляем разворот на 180° (кроме режима испуга)
-    if (mode != GhostMode::FRIGHTENED) {
-        possibleDirs.erase(std::remove_if(possibleDirs.begin(), possibleDirs.end(),
-            [this](Direction dir) {
-                return (dir == Direction::UP && currentDir == Direction::DOWN) ||
-                       (dir == Direction::DOWN && currentDir == Direction::UP) ||
-                       (dir == Direction::LEFT && currentDir == Direction::RIGHT) ||
-                       (dir == Direction::RIGHT && currentDir == Direction::LEFT);
-            }), possibleDirs.end());
-    }
-
-    if (possibleDirs.empty()) {
-        if (!canMove(currentDir, levelMap)) {
-            currentDir = Direction::NONE;
-        }
-        return;
-    }
-
-    // Выбираем оптимальное направление
-    Direction bestDir = possibleDirs[0];
-    int minDistance = INT_MAX;
-    
-    for (Direction dir : possibleDirs) {
-        int newX = tileX;
-        int newY = tileY;
-        
-        switch(dir) {
-            case Direction::UP: newY--; break;
-            case Direction::DOWN: newY++; break;
-            case Direction::LEFT: newX /= 2; newX--; break;
-            case Direction::RIGHT: newX++; break;
-        }
-        
-        int dist = abs(newX - targetTileX) + abs(newY - targetTileY);
-        
-        if (dist < minDistance) {
-            minDistance = dist;
-            bestDir = dir;
-        }
-    }
-    
-    currentDir = bestDir;
+void Ghost::syncFromSystem() {
+    if (!system) return;
+    tileX = system->getTileX(index);
+    tileY = system->getTileY(index);
+    posX = system->getPosX(index);
+    posY = system->getPosY(index);
+    currentDir = system->getDirection(index);
+    hitbox.x = getPixelX() - 8;
+    hitbox.y = getPixelY() - 8;
 }
 
 void Ghost::render(SDL_Renderer* renderer) {
-    if (!getIsActive() || isEaten) return;
+    if (!getIsActive() || getIsEaten()) return;
 
-    SDL_Texture* textureToUse = (mode == GhostMode::FRIGHTENED) ? 
+    SDL_Texture* textureToUse = (getMode() == GhostMode::FRIGHTENED) ? 
                               textureFrightened : textureNormal;
 
     SDL_RenderCopyEx(
@@ -332,112 +307,108 @@ void Ghost::render(SDL_Renderer* renderer) {
     );
 }
 
-void Ghost::changeMode(GhostMode newMode) {
-    if (newMode != GhostMode::FRIGHTENED) {
-        modeTimer = 0.0f;
-    }
-
-    if (newMode != mode && !isEaten) {
-        switch(currentDir) {
-            case Direction::UP: currentDir = Direction::DOWN; break;
-            case Direction::DOWN: currentDir = Direction::UP; break;
-            case Direction::LEFT: currentDir = Direction::RIGHT; break;
-            case Direction::RIGHT: currentDir = Direction::LEFT; break;
-        }
-    }
-    
-    mode = newMode;
+void Ghost::setPosition(int tileX, int tileY) {
+    GameObject::setPosition(tileX, tileY);
+    if (system) system->setPosition(index, tileX, tileY);
 }
 
-void Ghost::setFrightened(bool frightened) {
-    if (frightened) {
-        mode = GhostMode::FRIGHTENED;
-        frightenedTimer = 5.0f;
-        switch(currentDir) {
-            case Direction::UP: currentDir = Direction::DOWN; break;
-            case Direction::DOWN: currentDir = Direction::UP; break;
-            case Direction::LEFT: currentDir = Direction::RIGHT; break;
-            case Direction::RIGHT: currentDir = Direction::LEFT; break;
-        }
-    } else {
-        mode = GhostMode::CHASE;
-    }
+GhostMode Ghost::getMode() const {
+    return system ? system->getMode(index) : GhostMode::SCATTER;
 }
 
-void Ghost::resetToStartPosition() {
-        setPosition(tileX, tileY);
-        isReleased = false;
-        releaseTimer = 0.0f;
-        changeMode(GhostMode::SCATTER);
-        setIsActive(true);
-}
-
-// Dot
-Dot::Dot(int x, int y, SDL_Renderer* renderer) : GameObject(x, y) {
-    texture = IMG_LoadTexture(renderer, "sprites/map/big-1.png");
-    setIsActive(true);
+void Ghost::changeMode(GhostMode newMode) {
+    if (!system) return;
+    system->changeMode(index, newMode);
+    syncFromSystem();
 }
 
-Dot::~Dot() {
-    SDL_DestroyTexture(texture);
+void Ghost::setFrightened(bool frightened) {
+    if (!system) return;
+    system->setFrightened(index, frightened);
+    syncFromSystem();
 }
 
-void Dot::render(SDL_Renderer* renderer) {
-    SDL_RenderCopy(renderer, texture, nullptr, &hitbox);
+void Ghost::resetToStartPosition() {
+    if (!system) return;
+    system->resetToStart(index);
+    syncFromSystem();
+    setIsActive(true);
 }
 
-// Energizer
-Energizer::Energizer(int x, int y, SDL_Renderer* renderer) : GameObject(x, y) {
-    texture = IMG_LoadTexture(renderer, "sprites/map/big-0.png");
-    setIsActive(true);
+bool Ghost::getIsEaten() const {
+    return system && system->getIsEaten(index);
 }
 
-Energizer::~Energizer() {
-    SDL_DestroyTexture(texture);
+void Ghost::setEaten(bool eaten) {
+    if (system) system->setEaten(index, eaten);
 }
 
-void Energizer::render(SDL_Renderer* renderer) {
-    SDL_RenderCopy(renderer, texture, nullptr, &hitbox);
+bool Ghost::getIsReleased() const {
+    return system && system->getIsReleased(index);
 }
 
 // Fruit
 const std::map<FruitType, std::string> Fruit::fruitTextures = {
+    {FruitType::CHERRY, "sprites/fruits/cherry.png"},
+    {FruitType::STRAWBERRY, "sprites/fruits/strawberry.png"},
     {FruitType::ORANGE, "sprites/fruits/orange.png"},
-    {FruitType::APPLE, "sprites/fruits/apple.png"}
+    {FruitType::APPLE, "sprites/fruits/apple.png"},
+    {FruitType::MELON, "sprites/fruits/melon.png"},
+    {FruitType::BOSS, "sprites/fruits/boss.png"},
+    {FruitType::BELL, "sprites/fruits/bell.png"},
+    {FruitType::KEY, "sprites/fruits/key.png"}
 };
 
-Fruit::Fruit(int x, int y, FruitType type, SDL_Renderer* renderer) : 
-    GameObject(x, y), type(type), visibleTime(9.0f) {
-    texture = IMG_LoadTexture(renderer, fruitTextures.at(type).c_str());
-    if (!texture) {
-        std::cerr << "Failed to load fruit texture: " << IMG_GetError() << std::endl;
-    }
+FruitType Fruit::typeForRound(int round) {
+    static const FruitType table[] = {
+        FruitType::CHERRY, FruitType::STRAWBERRY,
+        FruitType::ORANGE, FruitType::ORANGE,
+        FruitType::APPLE, FruitType::APPLE,
+        FruitType::MELON, FruitType::MELON,
+        FruitType::BOSS, FruitType::BOSS,
+        FruitType::BELL, FruitType::BELL
+    };
+    const int count = sizeof(table) / sizeof(table[0]);
+    if (round < 1) round = 1;
+    return round <= count ? table[round - 1] : FruitType::KEY;
+}
+
+Fruit::Fruit(int x, int y, FruitType type, SDL_Texture* icon) : 
+    GameObject(x, y), type(type), icon(icon) {
     setIsActive(true);
 }
 
-Fruit::~Fruit() {
-    if (texture) {
-        SDL_DestroyTexture(texture);
+Fruit::~Fruit() {}
+
+void Fruit::render(SDL_Renderer* renderer) {
+    if (icon) {
+        SDL_RenderCopy(renderer, icon, nullptr, &hitbox);
     }
 }
 
-void Fruit::update(float deltaTime) {
-    visibleTime -= deltaTime;
-    if (visibleTime <= 0) {
-        setIsActive(false);
+int Fruit::pointsFor(FruitType type) {
+    switch(type) {
+        case FruitType::CHERRY:     return 100;
+        case FruitType::STRAWBERRY: return 300;
+        case FruitType::ORANGE:     return 500;
+        case FruitType::APPLE:      return 700;
+        case FruitType::MELON:      return 1000;
+        case FruitType::BOSS:       return 2000;
+        case FruitType::BELL:       return 3000;
+        case FruitType::KEY:        return 5000;
+        default: return 0;
     }
 }
 
-void Fruit::render(SDL_Renderer* renderer) {
+// Pellet
+Pellet::Pellet(int x, int y, PelletKind kind, SDL_Texture* sprite) : GameObject(x, y), kind(kind) {
+    texture = sprite;
+}
+
+Pellet::~Pellet() {}
+
+void Pellet::render(SDL_Renderer* renderer) {
     if (texture) {
         SDL_RenderCopy(renderer, texture, nullptr, &hitbox);
     }
 }
-
-int Fruit::getPoints() const {
-    switch(type) {
-        case FruitType::ORANGE: return 100;
-        case FruitType::APPLE:  return 500;
-        default: return 0;
-    }
-}
\ No newline at end of file
@@ -6,40 +6,90 @@
 #include <memory>
 #include <iostream>
 #include <map>
+#include <bitset>
+#include "FixedPoint.h"
+#include "Pickups.h"
+#include "Varint.h"
 
 enum class Direction { UP, RIGHT, DOWN, LEFT, NONE };
 enum class GhostMode { CHASE, SCATTER, FRIGHTENED, EATEN };
-enum class FruitType { ORANGE, APPLE };
+// Фрукты в порядке появления по раундам, как в оригинальной игре
+enum class FruitType { CHERRY, STRAWBERRY, ORANGE, APPLE, MELON, BOSS, BELL, KEY };
+const int kFruitTypeCount = 8;
+
+class GhostSystem;
+class AssetManager;
+
+// Маска направлений: бит i соответствует Direction(i), NONE в маску не входит
+inline unsigned directionBit(Direction dir) {
+    return dir == Direction::NONE ? 0u : 1u << static_cast<unsigned>(dir);
+}
+
+inline Direction oppositeDirection(Direction dir) {
+    if (dir == Direction::NONE) return Direction::NONE;
+    return static_cast<Direction>((static_cast<unsigned>(dir) + 2) & 3u);
+}
+
+inline int exitCount(unsigned exits) {
+    return static_cast<int>(std::bitset<4>(exits).count());
+}
+
+// n-е (с нуля) разрешённое направление в маске
+inline Direction nthExit(unsigned exits, int n) {
+    for (unsigned bit = 0; bit < 4; ++bit) {
+        if ((exits >> bit) & 1u) {
+            if (n-- == 0) return static_cast<Direction>(bit);
+        }
+    }
+    return Direction::NONE;
+}
 
 class GameObject {
 protected:
     int tileX, tileY;
-    int pixelX, pixelY;
+    Fixed posX, posY; // центр объекта в пикселях, 16.16
     SDL_Rect hitbox;
     bool isActive;
     Direction currentDir;
     Direction nextDir;
-    SDL_Texture* texture;
+    int nextDirTicks; // сколько тиков ещё действует nextDir
+    SDL_Texture* texture; // принадлежит AssetManager
+
+    void applyBufferedTurn(const std::vector<std::string>& levelMap);
+    // Скорость за тик; неподвижные объекты её не переопределяют
+    virtual Fixed tickSpeed(const std::vector<std::string>& levelMap) const { return 0; }
 
 public:
+    // Нажатие помнится ~0.2 с при 60 тиках; поворот возможен за 4 пикселя до центра
+    static const int kTurnBufferTicks = 12;
+    static const int kCornerWindow = 4;
+
     GameObject(int x, int y);
     virtual ~GameObject();
     virtual void update(float deltaTime) {};
     virtual void render(SDL_Renderer* renderer) = 0;
+    static bool canMoveFrom(int tileX, int tileY, Direction dir, const std::vector<std::string>& levelMap);
+    static unsigned exitsAt(int tileX, int tileY, const std::vector<std::string>& levelMap);
+    static bool isTunnelTile(int tileX, int tileY, const std::vector<std::string>& levelMap);
     bool canMove(Direction dir, const std::vector<std::string>& levelMap) const;
-    void move(float deltaTime, const std::vector<std::string>& levelMap);
+    unsigned getExits(const std::vector<std::string>& levelMap) const;
+    // Один тик движения
+    void move(const std::vector<std::string>& levelMap);
     SDL_Rect getHitbox() const { return hitbox; }
     bool getIsActive() const { return isActive; }
     void setIsActive(bool active) { isActive = active; }
     Direction getDirection() const { return currentDir; }
-    void setNextDirection(Direction dir) { nextDir = dir; }
+    void setNextDirection(Direction dir);
     bool checkCollision(const GameObject& other) const { return SDL_HasIntersection(&this->hitbox, &other.hitbox); }
     int getTileX() const { return tileX; }
     int getTileY() const { return tileY; }
-    int getPixelX() const { return pixelX; }
-    int getPixelY() const { return pixelY; }
-    void setPosition(int tileX, int tileY);
-    
+    int getPixelX() const { return fixedFloor(posX); }
+    int getPixelY() const { return fixedFloor(posY); }
+    virtual void setPosition(int tileX, int tileY);
+
+    // Положение, направление и буфер поворота - для ключевых кадров повтора
+    void saveMotion(std::vector<uint8_t>& out) const;
+    bool restoreMotion(ByteReader& in);
 };
 
 class Pacman : public GameObject {
@@ -51,9 +101,14 @@ private:
     int lives;
     int score;
     bool isPowered;
+    SpeedTable speeds = kPacmanSpeeds;
+
+protected:
+    Fixed tickSpeed(const std::vector<std::string>& levelMap) const override;
 
 public:
-    Pacman(int x, int y, SDL_Renderer* renderer);
+    // renderer - рендерер уровня, nullptr - без текстур (см. AssetManager::getTexture)
+    Pacman(int x, int y, SDL_Renderer* renderer, AssetManager& assets);
     ~Pacman() override;
     void update(float deltaTime) override;
     void render(SDL_Renderer* renderer) override;
@@ -66,69 +121,67 @@ public:
     void setLives(int newLives) { lives = newLives; }
     void setScore(int newScore) { score = newScore; }
     bool getIsPowered() const { return isPowered; }
+    bool getMouthOpen() const { return mouthOpen; }
+    void setSpeeds(const SpeedTable& table) { speeds = table; }
+
+    void saveState(std::vector<uint8_t>& out) const;
+    bool restoreState(ByteReader& in);
 };
 
+// Состояние призрака хранится в GhostSystem, объект читает его по индексу
 class Ghost : public GameObject {
 private:
     SDL_Texture* textureNormal;
     SDL_Texture* textureFrightened;
-    GhostMode mode = GhostMode::SCATTER;
-    float modeTimer = 0.0f;
-    bool isReleased = false;
-    float releaseTimer = 0.0f;
-    int targetX = 0;
-    int targetY = 0;
-    void updateAI(const Pacman* pacman, const std::vector<std::string>& levelMap);
-    float modeSwitchTimer;
-    bool isInChaseMode;
-    float frightenedTimer = 0;
-    static int ghostsEaten;
-    bool isEaten = false;
+    GhostSystem* system = nullptr;
+    size_t index = 0;
 
 public:
-    Ghost(int x, int y, SDL_Renderer* renderer);
+    Ghost(int x, int y, SDL_Renderer* renderer, AssetManager& assets);
     ~Ghost() override;
-    void update(float deltaTime, const Pacman* pacman, std::vector<std::string>& levelMap);
+    void attach(GhostSystem* ghostSystem, size_t ghostIndex);
+    void syncFromSystem();
     void render(SDL_Renderer* renderer) override;
-    GhostMode getMode() const { return mode; }
+    void setPosition(int tileX, int tileY) override;
+    GhostMode getMode() const;
     void changeMode(GhostMode newMode);
     void resetToStartPosition();
     void setFrightened(bool frightened);
-    bool getIsEaten() const { return isEaten; }
-    void setEaten(bool eaten) { isEaten = eaten; }
-    bool getIsReleased() { return isReleased; }
-};
-
-class Dot : public GameObject {
-public:
-    Dot(int x, int y, SDL_Renderer* renderer);
-    ~Dot() override;
-
-    void update(float deltaTime) override {}
-    void render(SDL_Renderer* renderer) override;
-};
-
-class Energizer : public GameObject {
-public:
-    Energizer(int x, int y, SDL_Renderer* renderer);
-    ~Energizer() override;
-
-    void update(float deltaTime) override {}
-    void render(SDL_Renderer* renderer) override;
+    bool getIsEaten() const;
+    void setEaten(bool eaten);
+    bool getIsReleased() const;
 };
 
+// Фрукт - предмет в PickupSystem (время жизни, очки, спрайт); объект
+// строится по месту (PickupSystem::fruitAt), например для ключевого кадра
 class Fruit : public GameObject {
 private:
     FruitType type;
-    float visibleTime;
+    SDL_Texture* icon; // принадлежит FruitIcons
     
 public:
     static const std::map<FruitType, std::string> fruitTextures;
+    static FruitType typeForRound(int round);
+    static int pointsFor(FruitType type);
 
-    Fruit(int x, int y, FruitType type, SDL_Renderer* renderer);
+    Fruit(int x, int y, FruitType type, SDL_Texture* icon);
     ~Fruit() override;
-    void update(float deltaTime) override;
     void render(SDL_Renderer* renderer) override;
-    int getPoints() const;
+    int getPoints() const { return pointsFor(type); }
     FruitType getType() const { return type; }
+};
+
+// Точка или энерджайзер: клетка в PickupSystem, объект строится по месту,
+// как Fruit. Хитбокс - вся клетка
+class Pellet : public GameObject {
+private:
+    PelletKind kind;
+
+public:
+    // sprite - текстура вида (kPickupRules), nullptr - без графики
+    Pellet(int x, int y, PelletKind kind, SDL_Texture* sprite = nullptr);
+    ~Pellet() override;
+    void render(SDL_Renderer* renderer) override;
+    PelletKind getKind() const { return kind; }
+    int getPoints() const { return kPickupRules[kind].points; }
 };
\ No newline at end of file
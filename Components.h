@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include "Characters.h"
+
+// Компоненты сущностей для Archetype: только данные, поведение - в системах
+// (GhostSystem, PickupSystem). Один тип - один компонент, поэтому две
+// разные пары координат - разные типы
+
+struct Tile {
+    int32_t x, y;
+};
+
+// Центр сущности в пикселях, 16.16
+struct Position {
+    Fixed x, y;
+};
+
+// Position до шага движения в текущем тике
+struct PreviousPosition {
+    Fixed x, y;
+};
+
+// Смещение за тик
+struct Velocity {
+    Fixed x, y;
+};
+
+struct Heading {
+    uint8_t dir; // Direction
+};
+
+// Текстура принадлежит AssetManager или FruitIcons; nullptr - без графики
+struct Sprite {
+    SDL_Texture* texture;
+};
+
+// Решения ИИ призрака. Генератор у каждого свой, чтобы решения не зависели
+// от порядка потоков
+struct GhostBrain {
+    uint8_t mode; // GhostMode
+    uint8_t released;
+    uint8_t eaten;
+    uint32_t rng;
+    int32_t spawnX, spawnY;
+};
+
+// Таймеры призрака: четыре float - один регистр SSE, весь компонент
+// продвигается одной операцией (см. GhostSystem::advanceTimers)
+struct alignas(16) GhostTimers {
+    float mode;
+    float release;
+    float frightened;
+    float unused;
+};
+
+// То, что Пакман подбирает: очки и вид клетки из kPickupRules
+// (PELLET_NONE - не клетка, например фрукт)
+struct Pickup {
+    int32_t points;
+    uint8_t kind; // PelletKind
+};
+
+// Сколько ещё секунд сущность на уровне
+struct Lifetime {
+    float seconds;
+};
+
+struct FruitInfo {
+    FruitType type;
+};
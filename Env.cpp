@@ -0,0 +1,127 @@
+#include "Env.h"
+#include "AssetManager.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const Direction kActionDirections[5] = {
+        Direction::NONE, Direction::UP, Direction::RIGHT, Direction::DOWN, Direction::LEFT
+    };
+}
+
+Env::Env(AssetManager& assets, const std::string& levelPath, int frameSkip)
+    : level(nullptr, assets), frameSkip(std::max(frameSkip, 1)) {
+    if (assets.hasRenderer()) {
+        throw std::runtime_error("Env: needs an AssetManager without a renderer");
+    }
+    if (!level.loadFromFile(levelPath)) {
+        throw std::runtime_error("Env: failed to load " + levelPath);
+    }
+}
+
+void Env::reset(uint32_t seed, uint8_t* observation) {
+    level.setSeed(seed);
+    level.restartLevel(false);
+    writeObservation(observation);
+}
+
+Env::StepResult Env::step(Action action, uint8_t* observation) {
+    Pacman* pacman = level.getPacman();
+    int scoreBefore = pacman->getScore();
+
+    if (action != Action::NOOP) {
+        pacman->setNextDirection(kActionDirections[static_cast<int>(action)]);
+    }
+    for (int i = 0; i < frameSkip && !level.isGameOver(); ++i) {
+        level.tick();
+    }
+
+    // Перезапуск раунда пересоздаёт Пакмана, счёт переносится
+    StepResult result;
+    result.reward = static_cast<float>(level.getPacman()->getScore() - scoreBefore);
+    result.done = level.isGameOver();
+    writeObservation(observation);
+    return result;
+}
+
+void Env::writeObservation(uint8_t* observation) {
+    const int width = getWidth();
+    const int height = getHeight();
+    const size_t plane = static_cast<size_t>(width) * height;
+    const std::vector<std::string>& map = level.getMap();
+
+    uint8_t* walls = observation + WALL * plane;
+    for (int y = 0; y < height; ++y) {
+        const std::string& row = map[y];
+        uint8_t* out = walls + y * width;
+        for (int x = 0; x < width; ++x) {
+            out[x] = x < static_cast<int>(row.size()) && row[x] == '#';
+        }
+    }
+
+    std::memcpy(observation + PELLET * plane, level.getPelletGrid().data(), plane);
+    std::memset(observation + PACMAN * plane, 0, 3 * plane);
+
+    auto mark = [&](Channel channel, int x, int y) {
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            observation[channel * plane + y * width + x] = 1;
+        }
+    };
+
+    const Pacman* pacman = level.getPacman();
+    mark(PACMAN, pacman->getTileX(), pacman->getTileY());
+
+    const GhostSystem& ghosts = level.getGhostSystem();
+    for (size_t i = 0; i < ghosts.size(); ++i) {
+        if (ghosts.getIsEaten(i)) continue;
+        Channel channel = ghosts.getMode(i) == GhostMode::FRIGHTENED ? FRIGHTENED : GHOST;
+        mark(channel, ghosts.getTileX(i), ghosts.getTileY(i));
+    }
+}
+
+VecEnv::VecEnv(AssetManager& assets, const std::string& levelPath, size_t count,
+               JobSystem* jobs, int frameSkip)
+    : nextSeeds(count, 0), jobs(jobs) {
+    envs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        envs.push_back(std::make_unique<Env>(assets, levelPath, frameSkip));
+    }
+}
+
+size_t VecEnv::grain() const {
+    // Несколько частей на поток, чтобы кража работы выравнивала нагрузку
+    size_t threads = jobs ? jobs->getWorkerCount() + 1 : 1;
+    return std::max<size_t>(1, envs.size() / (threads * 4));
+}
+
+void VecEnv::reset(uint32_t seed, uint8_t* observations) {
+    const size_t stride = observationSize();
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            // Зёрна сред не пересекаются: следующее зерно среды - через size()
+            envs[i]->reset(seed + static_cast<uint32_t>(i), observations + i * stride);
+            nextSeeds[i] = seed + static_cast<uint32_t>(i + envs.size());
+        }
+    };
+    if (jobs) jobs->parallelFor(envs.size(), grain(), body);
+    else body(0, envs.size());
+}
+
+void VecEnv::step(const Env::Action* actions, uint8_t* observations, float* rewards, uint8_t* dones) {
+    const size_t stride = observationSize();
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Env::StepResult result = envs[i]->step(actions[i], observations + i * stride);
+            rewards[i] = result.reward;
+            dones[i] = result.done ? 1 : 0;
+            if (result.done) {
+                envs[i]->reset(nextSeeds[i], observations + i * stride);
+                nextSeeds[i] += static_cast<uint32_t>(envs.size());
+            }
+        }
+    };
+    if (jobs) jobs->parallelFor(envs.size(), grain(), body);
+    else body(0, envs.size());
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Level.h"
+
+class AssetManager;
+class JobSystem;
+
+// Среда для обучения агентов поверх безголового Level. Один шаг - один тик
+// симуляции (kTickSeconds) или frameSkip тиков с тем же действием.
+// Карта читается и разбирается один раз в конструкторе, reset только
+// перестраивает раунд из разобранной карты.
+//
+// Каждой среде нужен AssetManager без рендерера (AssetManager(nullptr)),
+// как у Simulation: VecEnv сбрасывает среды в потоках JobSystem, и менеджер
+// с рендерером в них не годится. Один такой менеджер можно отдать всем средам.
+//
+// Наблюдение - тензор uint8 [kChannels][высота][ширина] по сетке layout,
+// записывается в буфер вызывающего без выделения памяти:
+//   WALL       - стена
+//   PELLET     - 1 точка, 2 энерджайзер
+//   PACMAN     - клетка Пакмана
+//   GHOST      - опасный призрак
+//   FRIGHTENED - испуганный призрак
+class Env {
+public:
+    enum class Action : uint8_t { NOOP, UP, RIGHT, DOWN, LEFT };
+    enum Channel { WALL, PELLET, PACMAN, GHOST, FRIGHTENED, kChannels };
+
+    struct StepResult {
+        float reward;  // прирост счёта за шаг
+        bool done;     // игра окончена
+    };
+
+    // Бросает std::runtime_error, если уровень не загрузился или у assets
+    // есть рендерер
+    Env(AssetManager& assets, const std::string& levelPath, int frameSkip = 1);
+
+    void reset(uint32_t seed, uint8_t* observation);
+    StepResult step(Action action, uint8_t* observation);
+
+    int getWidth() const { return level.getGridWidth(); }
+    int getHeight() const { return level.getGridHeight(); }
+    size_t observationSize() const { return static_cast<size_t>(kChannels) * getWidth() * getHeight(); }
+    const Level& getLevel() const { return level; }
+
+private:
+    Level level;
+    int frameSkip;
+
+    void writeObservation(uint8_t* observation);
+};
+
+// N сред, которые шагают синхронно на JobSystem. Завершившиеся среды
+// сразу сбрасываются со следующим зерном, их наблюдение - уже после сброса.
+class VecEnv {
+public:
+    VecEnv(AssetManager& assets, const std::string& levelPath, size_t count,
+           JobSystem* jobs, int frameSkip = 1);
+
+    size_t size() const { return envs.size(); }
+    size_t observationSize() const { return envs.front()->observationSize(); }
+
+    // observations - size() * observationSize() байт
+    void reset(uint32_t seed, uint8_t* observations);
+    void step(const Env::Action* actions, uint8_t* observations, float* rewards, uint8_t* dones);
+
+private:
+    std::vector<std::unique_ptr<Env>> envs;
+    std::vector<uint32_t> nextSeeds;
+    JobSystem* jobs;
+
+    size_t grain() const;
+};
@@ -0,0 +1,85 @@
+// Замер скорости среды обучения (Env, VecEnv) на случайных действиях:
+//   envbench [файл уровня] [--steps N] [--envs N] [--batches N]
+// Одна среда делает N шагов подряд, затем VecEnv из --envs сред делает
+// --batches синхронных шагов на JobSystem. Запускать из каталога с levels/.
+#include "AssetManager.h"
+#include "Env.h"
+#include "JobSystem.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+    // Воспроизводимые действия без std::rand: xorshift32
+    Env::Action randomAction(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<Env::Action>(state % 5);
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string levelPath = "levels/level1.txt";
+    long steps = 200000;
+    size_t envCount = 256;
+    long batches = 2000;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--steps") == 0 && hasValue) steps = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--envs") == 0 && hasValue) envCount = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--batches") == 0 && hasValue) batches = std::atol(argv[++i]);
+        else if (argv[i][0] != '-') levelPath = argv[i];
+        else std::cerr << "Unknown option: " << argv[i] << std::endl;
+    }
+    if (steps <= 0 || envCount == 0 || batches <= 0) {
+        std::cerr << "envbench: steps, envs and batches must be positive" << std::endl;
+        return 1;
+    }
+
+    AssetManager assets(nullptr);
+    uint32_t random = 1;
+    try {
+        Env env(assets, levelPath);
+        std::vector<uint8_t> observation(env.observationSize());
+        env.reset(0, observation.data());
+        long games = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < steps; ++i) {
+            if (env.step(randomAction(random), observation.data()).done) {
+                env.reset(static_cast<uint32_t>(++games), observation.data());
+            }
+        }
+        const double singleSeconds = secondsSince(start);
+
+        JobSystem jobs;
+        VecEnv vec(assets, levelPath, envCount, &jobs);
+        std::vector<uint8_t> observations(vec.size() * vec.observationSize());
+        std::vector<Env::Action> actions(vec.size());
+        std::vector<float> rewards(vec.size());
+        std::vector<uint8_t> dones(vec.size());
+        vec.reset(0, observations.data());
+        start = std::chrono::steady_clock::now();
+        for (long batch = 0; batch < batches; ++batch) {
+            for (Env::Action& action : actions) action = randomAction(random);
+            vec.step(actions.data(), observations.data(), rewards.data(), dones.data());
+        }
+        const double vecSeconds = secondsSince(start);
+
+        std::cout << "Env:    " << steps << " steps in " << singleSeconds << " s, "
+                  << static_cast<long>(steps / singleSeconds) << " steps/s, games: " << games << std::endl;
+        std::cout << "VecEnv: " << envCount << " envs x " << batches << " steps on " << jobs.getWorkerCount() + 1
+                  << " threads in " << vecSeconds << " s, "
+                  << static_cast<long>(envCount * batches / vecSeconds) << " steps/s" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
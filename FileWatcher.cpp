@@ -0,0 +1,70 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define FILEWATCHER_HAS_INOTIFY 1
+#endif
+
+FileWatcher::~FileWatcher() {
+#ifdef FILEWATCHER_HAS_INOTIFY
+    if (fd >= 0) ::close(fd);
+#endif
+}
+
+bool FileWatcher::watch(const std::string& directory) {
+    for (const Directory& dir : directories) {
+        if (dir.path == directory) return true;
+    }
+#ifdef FILEWATCHER_HAS_INOTIFY
+    if (fd < 0) {
+        fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            std::cerr << "File watcher: inotify_init1() failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        buffer.resize(64 * 1024);
+    }
+    const int wd = ::inotify_add_watch(fd, directory.empty() ? "." : directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        std::cerr << "File watcher: cannot watch " << directory << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    directories.push_back({wd, directory});
+    return true;
+#else
+    std::cerr << "File watcher: inotify is not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+std::vector<std::string> FileWatcher::poll() {
+    std::vector<std::string> changed;
+#ifdef FILEWATCHER_HAS_INOTIFY
+    if (fd < 0) return changed;
+    for (;;) {
+        const ssize_t size = ::read(fd, buffer.data(), buffer.size());
+        if (size <= 0) break;
+        for (ssize_t offset = 0; offset < size;) {
+            inotify_event event;
+            std::memcpy(&event, buffer.data() + offset, sizeof(event));
+            const char* name = buffer.data() + offset + sizeof(event);
+            offset += static_cast<ssize_t>(sizeof(event) + event.len);
+            if (event.len == 0) continue;
+
+            auto dir = std::find_if(directories.begin(), directories.end(),
+                                    [&](const Directory& d) { return d.wd == event.wd; });
+            if (dir == directories.end()) continue;
+            std::string path = dir->path.empty() ? name : dir->path + "/" + name;
+            if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+                changed.push_back(std::move(path));
+            }
+        }
+    }
+#endif
+    return changed;
+}
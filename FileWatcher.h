@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Изменения файлов в каталогах через inotify, без блокировки: poll()
+// только забирает накопившиеся события. Файл считается изменённым, когда
+// его закрыли после записи или переименовали в каталог (так сохраняют
+// многие редакторы). На системах без inotify watch() возвращает false.
+class FileWatcher {
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Каталог, который уже отслеживается, повторно не добавляется
+    bool watch(const std::string& directory);
+    // Пути (каталог/имя, как в watch) файлов, изменённых с прошлого вызова,
+    // каждый один раз
+    std::vector<std::string> poll();
+
+private:
+    struct Directory {
+        int wd;
+        std::string path;
+    };
+
+    int fd = -1;
+    std::vector<Directory> directories;
+    std::vector<char> buffer;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+
+// Координаты и скорости в формате 16.16: старшие 16 бит - пиксели,
+// младшие - доли пикселя. Движение считается целыми числами и одинаково
+// на любой машине и при любой частоте кадров.
+using Fixed = int32_t;
+
+// Частота тиков симуляции, на неё рассчитаны скорости ниже
+const int kTicksPerSecond = 60;
+const float kTickSeconds = 1.0f / kTicksPerSecond;
+
+const int kFixedShift = 16;
+const Fixed kFixedOne = 1 << kFixedShift;
+
+constexpr Fixed toFixed(int value) { return value * kFixedOne; }
+// Арифметический сдвиг - округление вниз и для отрицательных значений
+constexpr int fixedFloor(Fixed value) { return value >> kFixedShift; }
+constexpr Fixed tileCenterFixed(int tile) { return toFixed(tile * 16 + 8); }
+
+// 100% скорости в оригинальной игре - 75.75757625 пикселя в секунду,
+// при 60 тиках в секунду это 1.26262627 пикселя за тик
+const Fixed kFullSpeedPerTick = 82747;
+
+constexpr Fixed speedPercent(int percent) {
+    return static_cast<Fixed>(static_cast<int64_t>(kFullSpeedPerTick) * percent / 100);
+}
+
+// Скорости за тик для разных состояний сущности
+struct SpeedTable {
+    Fixed normal;
+    Fixed frightened; // у Пакмана - пока действует энерджайзер
+    Fixed tunnel;
+    Fixed eaten;      // глаза съеденного призрака
+};
+
+const SpeedTable kPacmanSpeeds = {speedPercent(80), speedPercent(90), speedPercent(80), speedPercent(80)};
+const SpeedTable kGhostSpeeds = {speedPercent(75), speedPercent(50), speedPercent(40), speedPercent(150)};
+
+// Таблица с множителем percent (скорость уровня кампании)
+constexpr Fixed scaleSpeed(Fixed speed, int percent) {
+    return static_cast<Fixed>(static_cast<int64_t>(speed) * percent / 100);
+}
+
+constexpr SpeedTable scaleSpeeds(const SpeedTable& table, int percent) {
+    return {scaleSpeed(table.normal, percent), scaleSpeed(table.frightened, percent),
+            scaleSpeed(table.tunnel, percent), scaleSpeed(table.eaten, percent)};
+}
@@ -0,0 +1,197 @@
+#include "FrameCapture.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    bool endsWith(const std::string& text, const char* suffix) {
+        const size_t length = std::strlen(suffix);
+        return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+    }
+
+    // BT.601 с полным диапазоном (C420jpeg), целочисленно
+    inline uint8_t lumaOf(int r, int g, int b) {
+        return static_cast<uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+    }
+
+    inline uint8_t chromaByte(int value) {
+        return static_cast<uint8_t>(std::clamp((value >> 8) + 128, 0, 255));
+    }
+}
+
+FrameCapture::~FrameCapture() {
+    close();
+}
+
+bool FrameCapture::open(const std::string& outputPath, int frameWidth, int frameHeight, int fps) {
+    close();
+    if (endsWith(outputPath, ".png")) {
+        format = Format::PNG;
+    } else if (endsWith(outputPath, ".y4m")) {
+        format = Format::Y4M;
+        // В 4:2:0 цветность - одна пара на квадрат 2x2
+        if (frameWidth % 2 != 0 || frameHeight % 2 != 0) {
+            std::cerr << "Capture: Y4M needs even frame size" << std::endl;
+            return false;
+        }
+        file.open(outputPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Failed to create capture " << outputPath << std::endl;
+            return false;
+        }
+        file << "YUV4MPEG2 W" << frameWidth << " H" << frameHeight << " F" << fps << ":1 Ip A1:1 C420jpeg\n";
+        yuv.resize(static_cast<size_t>(frameWidth) * frameHeight * 3 / 2);
+    } else {
+        std::cerr << "Capture: unknown format of " << outputPath << " (expected .y4m or .png)" << std::endl;
+        return false;
+    }
+
+    path = outputPath;
+    width = frameWidth;
+    height = frameHeight;
+    buffers.assign(kBufferCount, std::vector<uint32_t>(static_cast<size_t>(width) * height));
+    freeBuffers.clear();
+    for (size_t i = 0; i < kBufferCount; ++i) freeBuffers.push_back(i);
+    queued.clear();
+    closing = false;
+    framesWritten = 0;
+    encodeMs = 0.0;
+    stallMs = 0.0;
+    writer = std::thread(&FrameCapture::writerLoop, this);
+    return true;
+}
+
+void FrameCapture::submit(const SDL_Surface* surface) {
+    if (!writer.joinable()) return;
+
+    size_t index;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (freeBuffers.empty()) {
+            const Uint64 start = SDL_GetPerformanceCounter();
+            bufferFreed.wait(lock, [this] { return !freeBuffers.empty(); });
+            stallMs += (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+        }
+        index = freeBuffers.front();
+        freeBuffers.pop_front();
+    }
+
+    // Поверхность программного рендерера в обычной памяти, копия построчно
+    // из-за выравнивания строк (pitch)
+    std::vector<uint32_t>& pixels = buffers[index];
+    const uint8_t* src = static_cast<const uint8_t*>(surface->pixels);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(&pixels[static_cast<size_t>(y) * width], src + static_cast<size_t>(y) * surface->pitch,
+                    static_cast<size_t>(width) * sizeof(uint32_t));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(index);
+    }
+    frameQueued.notify_one();
+}
+
+void FrameCapture::close() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        frameQueued.notify_one();
+        writer.join();
+    }
+    if (file.is_open()) file.close();
+}
+
+uint64_t FrameCapture::getFramesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return framesWritten;
+}
+
+double FrameCapture::getEncodeMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return framesWritten ? encodeMs / framesWritten : 0.0;
+}
+
+void FrameCapture::writerLoop() {
+    for (;;) {
+        size_t index;
+        uint64_t frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            frameQueued.wait(lock, [this] { return closing || !queued.empty(); });
+            if (queued.empty()) return;
+            index = queued.front();
+            queued.pop_front();
+            frame = framesWritten;
+        }
+
+        const Uint64 start = SDL_GetPerformanceCounter();
+        const bool ok = format == Format::Y4M ? writeY4M(buffers[index]) : writePNG(buffers[index], frame);
+        const double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+        if (!ok) {
+            std::cerr << "Capture: failed to write frame " << frame << " to " << path << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeBuffers.push_back(index);
+            framesWritten++;
+            encodeMs += ms;
+        }
+        bufferFreed.notify_one();
+    }
+}
+
+bool FrameCapture::writeY4M(const std::vector<uint32_t>& pixels) {
+    uint8_t* lumaPlane = yuv.data();
+    uint8_t* uPlane = lumaPlane + static_cast<size_t>(width) * height;
+    uint8_t* vPlane = uPlane + static_cast<size_t>(width / 2) * (height / 2);
+
+    for (int y = 0; y < height; y += 2) {
+        const uint32_t* row0 = &pixels[static_cast<size_t>(y) * width];
+        const uint32_t* row1 = row0 + width;
+        uint8_t* luma0 = lumaPlane + static_cast<size_t>(y) * width;
+        uint8_t* luma1 = luma0 + width;
+        const size_t chromaRow = static_cast<size_t>(y / 2) * (width / 2);
+        for (int x = 0; x < width; x += 2) {
+            // Яркость на каждый пиксель, цветность - по среднему квадрата 2x2
+            int sumR = 0, sumG = 0, sumB = 0;
+            const uint32_t quad[4] = {row0[x], row0[x + 1], row1[x], row1[x + 1]};
+            uint8_t* const luma[4] = {&luma0[x], &luma0[x + 1], &luma1[x], &luma1[x + 1]};
+            for (int i = 0; i < 4; ++i) {
+                const int r = (quad[i] >> 16) & 0xFF;
+                const int g = (quad[i] >> 8) & 0xFF;
+                const int b = quad[i] & 0xFF;
+                *luma[i] = lumaOf(r, g, b);
+                sumR += r;
+                sumG += g;
+                sumB += b;
+            }
+            const int r = sumR / 4, g = sumG / 4, b = sumB / 4;
+            uPlane[chromaRow + x / 2] = chromaByte(-43 * r - 85 * g + 128 * b + 128);
+            vPlane[chromaRow + x / 2] = chromaByte(128 * r - 107 * g - 21 * b + 128);
+        }
+    }
+
+    file << "FRAME\n";
+    file.write(reinterpret_cast<const char*>(yuv.data()), static_cast<std::streamsize>(yuv.size()));
+    return static_cast<bool>(file);
+}
+
+bool FrameCapture::writePNG(const std::vector<uint32_t>& pixels, uint64_t frame) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_%06llu.png", static_cast<unsigned long long>(frame));
+    const std::string name = path.substr(0, path.size() - 4) + suffix;
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint32_t*>(pixels.data()), width, height, 32,
+                                                              width * static_cast<int>(sizeof(uint32_t)),
+                                                              SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return false;
+    const bool ok = IMG_SavePNG(surface, name.c_str()) == 0;
+    SDL_FreeSurface(surface);
+    return ok;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Запись отрисованных кадров в файл в отдельном потоке. Форматы:
+//   *.y4m - видео без сжатия (YUV 4:2:0), его читают ffmpeg и mpv;
+//   *.png - последовательность картинок: frame.png -> frame_000000.png, ...
+// submit копирует поверхность в свободный буфер небольшого пула, а перевод
+// в YUV или сжатие PNG идут в потоке записи, параллельно с симуляцией и
+// отрисовкой следующих кадров. Если запись отстала и все буферы заняты,
+// submit ждёт: кадры не теряются, прогон просто идёт со скоростью записи.
+class FrameCapture {
+public:
+    static const size_t kBufferCount = 4;
+
+    FrameCapture() = default;
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    bool open(const std::string& path, int width, int height, int fps);
+    // surface - ARGB8888 размера из open
+    void submit(const SDL_Surface* surface);
+    // Дописывает очередь и закрывает файл
+    void close();
+
+    uint64_t getFramesWritten() const;
+    // Среднее время кодирования и записи одного кадра в потоке записи
+    double getEncodeMs() const;
+    // Сколько всего submit ждал свободного буфера
+    double getStallMs() const { return stallMs; }
+
+private:
+    enum class Format { Y4M, PNG };
+
+    Format format = Format::Y4M;
+    std::string path;
+    int width = 0;
+    int height = 0;
+    std::ofstream file;
+
+    std::vector<std::vector<uint32_t>> buffers;
+    std::vector<uint8_t> yuv;
+    std::thread writer;
+    mutable std::mutex mutex;
+    std::condition_variable bufferFreed;
+    std::condition_variable frameQueued;
+    std::deque<size_t> freeBuffers;  // под mutex
+    std::deque<size_t> queued;       // под mutex
+    bool closing = false;            // под mutex
+    uint64_t framesWritten = 0;      // под mutex
+    double encodeMs = 0.0;           // под mutex
+    double stallMs = 0.0;
+
+    void writerLoop();
+    bool writeY4M(const std::vector<uint32_t>& pixels);
+    bool writePNG(const std::vector<uint32_t>& pixels, uint64_t frame);
+};
@@ -0,0 +1,132 @@
+#include "FrameRenderer.h"
+#include "AssetManager.h"
+#include <cstdio>
+#include <iostream>
+
+FrameRenderer::FrameRenderer(SDL_Renderer* renderer, AssetManager& assets)
+    : renderer(renderer), fruitIcons(renderer, assets), pelletLayer(renderer, assets) {
+    if (!renderer) return;
+
+    font = assets.openFont("fonts/arial.ttf", 24);
+    if (!font) {
+        std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
+    }
+    pacmanOpen = assets.getTexture("sprites/pacman/1.png", renderer);
+    pacmanClosed = assets.getTexture("sprites/pacman/2.png", renderer);
+    ghostNormal = assets.getTexture("sprites/ghosts/b-0.png", renderer);
+    ghostFrightened = assets.getTexture("sprites/ghosts/f-0.png", renderer);
+}
+
+FrameRenderer::~FrameRenderer() {
+    if (font) TTF_CloseFont(font);
+}
+
+void FrameRenderer::invalidate() {
+    pelletLayer.invalidate();
+    fruitIcons.invalidateStrip();
+}
+
+void FrameRenderer::render(const FrameSnapshot& frame) {
+    if (!renderer) return;
+    const StreamState& world = frame.world;
+
+    renderMaze(world);
+    pelletLayer.render(world.cells, world.width, world.height, frame.pelletVersion);
+
+    if (frame.hasFruit) {
+        SDL_Rect rect = {frame.fruitX - 8, frame.fruitY - 8, 16, 16};
+        SDL_RenderCopy(renderer, fruitIcons.get(frame.fruitType), nullptr, &rect);
+    }
+
+    renderEntities(frame);
+    fruitIcons.renderStrip(frame.eatenFruits, 100, world.height * 16 + 10);
+
+    int uiX = 24 * 16 + 20;
+    int uiY = 50;
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Color yellow = {255, 255, 0, 255};
+
+    if (!world.entities.empty()) {
+        renderText("Lives:", uiX, uiY, white);
+        renderText(std::to_string(world.lives), uiX + 100, uiY, yellow);
+        renderText("Score:", uiX, uiY + 40, white);
+        renderText(std::to_string(world.score), uiX + 100, uiY + 40, yellow);
+    }
+
+    if (frame.timeScale != 1.0f) {
+        renderSpeed(frame, uiX, uiY + 80);
+    }
+    if (frame.rewinding) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "<< %.1f s", frame.rewindSeconds);
+        renderText(text, uiX, uiY + 120, SDL_Color{120, 200, 255, 255});
+    }
+}
+
+void FrameRenderer::renderSpeed(const FrameSnapshot& frame, int x, int y) {
+    // "x4  238/240 tps": красным, если симуляция не успевает за ускорением
+    const int requested = static_cast<int>(kTicksPerSecond * frame.timeScale + 0.5f);
+    const int achieved = static_cast<int>(frame.tickRate + 0.5f);
+    char text[64];
+    if (frame.timeScale < 1.0f) {
+        std::snprintf(text, sizeof(text), "x%.2g  %d/%d tps", frame.timeScale, achieved, requested);
+    } else {
+        std::snprintf(text, sizeof(text), "x%d  %d/%d tps", static_cast<int>(frame.timeScale), achieved, requested);
+    }
+    const bool behind = frame.tickRate < requested * 0.95f;
+    renderText(text, x, y, behind ? SDL_Color{255, 80, 80, 255} : SDL_Color{120, 255, 120, 255});
+}
+
+void FrameRenderer::renderMaze(const StreamState& world) {
+    SDL_SetRenderDrawColor(renderer, 33, 33, 255, 255);
+
+    for (int y = 0; y < world.height; ++y) {
+        for (int x = 0; x < world.width; ++x) {
+            if (world.cells[y * world.width + x] == STREAM_WALL) {
+                SDL_Rect wall = {x * 16, y * 16, 16, 16};
+                SDL_RenderFillRect(renderer, &wall);
+            }
+        }
+    }
+}
+
+void FrameRenderer::renderEntities(const FrameSnapshot& frame) {
+    const std::vector<StreamEntity>& entities = frame.world.entities;
+    if (entities.empty()) return;
+
+    // Сущность 0 - Пакман, спрайт повёрнут по направлению движения
+    const StreamEntity& pacman = entities[0];
+    if (pacman.flags & STREAM_ACTIVE) {
+        int renderAngle = 180;
+        switch (static_cast<Direction>(pacman.dir)) {
+            case Direction::RIGHT: renderAngle = 180; break;
+            case Direction::DOWN:  renderAngle = 270; break;
+            case Direction::LEFT:  renderAngle = 0; break;
+            case Direction::UP:    renderAngle = 90; break;
+            case Direction::NONE:  renderAngle = 180; break;
+        }
+        SDL_Rect rect = {pacman.x - 8, pacman.y - 8, 16, 16};
+        SDL_RenderCopyEx(renderer, frame.mouthOpen ? pacmanOpen : pacmanClosed, nullptr, &rect,
+                         renderAngle, nullptr, SDL_FLIP_NONE);
+    }
+
+    for (size_t i = 1; i < entities.size(); ++i) {
+        const StreamEntity& ghost = entities[i];
+        if (ghost.flags & STREAM_EATEN) continue;
+        const auto mode = static_cast<GhostMode>((ghost.flags >> STREAM_MODE_SHIFT) & 3);
+        SDL_Rect rect = {ghost.x - 8, ghost.y - 8, 16, 16};
+        SDL_RenderCopyEx(renderer, mode == GhostMode::FRIGHTENED ? ghostFrightened : ghostNormal, nullptr, &rect,
+                         ghost.dir * 90, nullptr, SDL_FLIP_NONE);
+    }
+}
+
+void FrameRenderer::renderText(const std::string& text, int x, int y, SDL_Color color) {
+    if (!font) return;
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
+    if (!surface) return;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_Rect rect = {x, y, surface->w, surface->h};
+    SDL_RenderCopy(renderer, texture, nullptr, &rect);
+    SDL_FreeSurface(surface);
+    SDL_DestroyTexture(texture);
+}
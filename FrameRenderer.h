@@ -0,0 +1,40 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <memory>
+#include <string>
+#include "FrameSnapshot.h"
+#include "FruitIcons.h"
+#include "PelletLayer.h"
+
+class AssetManager;
+
+// Отрисовка уровня по снимку FrameSnapshot. Живых объектов уровня не
+// касается, поэтому рисует и в потоке рендера, пока симуляция идёт в своём
+// потоке, и у зрителя трансляции, где объектов нет вовсе.
+class FrameRenderer {
+public:
+    FrameRenderer(SDL_Renderer* renderer, AssetManager& assets);
+    ~FrameRenderer();
+    FrameRenderer(const FrameRenderer&) = delete;
+    FrameRenderer& operator=(const FrameRenderer&) = delete;
+
+    void render(const FrameSnapshot& frame);
+    // Содержимое текстур-целей теряется при SDL_RENDER_TARGETS_RESET
+    void invalidate();
+
+private:
+    SDL_Renderer* renderer;
+    TTF_Font* font = nullptr;
+    SDL_Texture* pacmanOpen = nullptr;
+    SDL_Texture* pacmanClosed = nullptr;
+    SDL_Texture* ghostNormal = nullptr;
+    SDL_Texture* ghostFrightened = nullptr;
+    FruitIcons fruitIcons;
+    PelletLayer pelletLayer;
+
+    void renderMaze(const StreamState& world);
+    void renderEntities(const FrameSnapshot& frame);
+    void renderSpeed(const FrameSnapshot& frame, int x, int y);
+    void renderText(const std::string& text, int x, int y, SDL_Color color);
+};
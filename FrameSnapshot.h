@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Characters.h"
+#include "StateStream.h"
+
+// Снимок уровня для отрисовки: всё, что нужно кадру, без ссылок на живые
+// объекты симуляции. Поток симуляции заполняет снимок после тиков, поток
+// рендера только читает его (см. TripleBuffer и Simulation).
+struct FrameSnapshot {
+    uint64_t tick = 0;
+    // Level::getStateHash на этом тике
+    uint64_t stateHash = 0;
+    // Клетки (стены и точки), сущности, счёт и жизни
+    StreamState world;
+    // Растёт при каждом изменении точек: слою точек не нужно сверять сетку,
+    // пока версия та же
+    uint32_t pelletVersion = 0;
+    bool mouthOpen = false;
+    bool hasFruit = false;
+    int16_t fruitX = 0, fruitY = 0;  // центр в пикселях
+    FruitType fruitType = FruitType::CHERRY;
+    std::vector<FruitType> eatenFruits;
+    bool gameOver = false;
+    // Заданный масштаб времени и фактическая частота тиков (тиков в секунду)
+    float timeScale = 1.0f;
+    float tickRate = 0.0f;
+    // Идёт перемотка назад; сколько секунд ещё можно отмотать
+    bool rewinding = false;
+    float rewindSeconds = 0.0f;
+};
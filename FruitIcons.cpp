@@ -0,0 +1,62 @@
+#include "FruitIcons.h"
+#include "AssetManager.h"
+#include <iostream>
+
+FruitIcons::FruitIcons(SDL_Renderer* renderer, AssetManager& assets) : renderer(renderer) {
+    if (!renderer) return;
+
+    for (const auto& entry : Fruit::fruitTextures) {
+        icons[static_cast<int>(entry.first)] = assets.getTexture(entry.second, renderer);
+    }
+
+    strip = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                              kStripSlots * kSpacing, kIconSize);
+    if (strip) {
+        SDL_SetTextureBlendMode(strip, SDL_BLENDMODE_BLEND);
+    } else {
+        std::cerr << "Fruit strip texture unavailable, drawing icons one by one: " << SDL_GetError() << std::endl;
+    }
+}
+
+FruitIcons::~FruitIcons() {
+    if (strip) SDL_DestroyTexture(strip);
+}
+
+SDL_Texture* FruitIcons::get(FruitType type) const {
+    return icons[static_cast<int>(type)];
+}
+
+void FruitIcons::rebuildStrip(const std::vector<FruitType>& eatenFruits) {
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, strip);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    for (size_t i = 0; i < eatenFruits.size() && i < kStripSlots; ++i) {
+        SDL_Rect dst = {static_cast<int>(i) * kSpacing, 0, kIconSize, kIconSize};
+        SDL_RenderCopy(renderer, get(eatenFruits[i]), nullptr, &dst);
+    }
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    stripCount = eatenFruits.size();
+    stripDirty = false;
+}
+
+void FruitIcons::renderStrip(const std::vector<FruitType>& eatenFruits, int x, int y) {
+    if (eatenFruits.empty()) return;
+
+    if (!strip) {
+        for (size_t i = 0; i < eatenFruits.size(); ++i) {
+            SDL_Rect dst = {x + static_cast<int>(i) * kSpacing, y, kIconSize, kIconSize};
+            SDL_RenderCopy(renderer, get(eatenFruits[i]), nullptr, &dst);
+        }
+        return;
+    }
+
+    if (stripDirty || stripCount != eatenFruits.size()) {
+        rebuildStrip(eatenFruits);
+    }
+
+    SDL_Rect dst = {x, y, kStripSlots * kSpacing, kIconSize};
+    SDL_RenderCopy(renderer, strip, nullptr, &dst);
+}
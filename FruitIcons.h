@@ -0,0 +1,36 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Characters.h"
+
+class AssetManager;
+
+// Иконки фруктов. Текстуры из Fruit::fruitTextures берутся из AssetManager
+// один раз, а полоса съеденных фруктов под лабиринтом хранится в одной
+// текстуре и перерисовывается только при изменении списка.
+class FruitIcons {
+public:
+    static const int kStripSlots = 7;
+    static const int kSpacing = 20;
+    static const int kIconSize = 16;
+
+    FruitIcons(SDL_Renderer* renderer, AssetManager& assets);
+    ~FruitIcons();
+    FruitIcons(const FruitIcons&) = delete;
+    FruitIcons& operator=(const FruitIcons&) = delete;
+
+    SDL_Texture* get(FruitType type) const;
+
+    // Помечает полосу устаревшей, она перерисуется при следующем renderStrip
+    void invalidateStrip() { stripDirty = true; }
+    void renderStrip(const std::vector<FruitType>& eatenFruits, int x, int y);
+
+private:
+    SDL_Renderer* renderer;
+    SDL_Texture* icons[kFruitTypeCount] = {};
+    SDL_Texture* strip = nullptr;
+    bool stripDirty = true;
+    size_t stripCount = 0;
+
+    void rebuildStrip(const std::vector<FruitType>& eatenFruits);
+};
@@ -0,0 +1,472 @@
+#include "GhostSystem.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Единичные шаги по осям для Direction (UP, RIGHT, DOWN, LEFT, NONE)
+    const int kStepX[5] = {0, 1, 0, -1, 0};
+    const int kStepY[5] = {-1, 0, 1, 0, 0};
+
+    const uint8_t kFrightened = static_cast<uint8_t>(GhostMode::FRIGHTENED);
+
+    // Меньше призраков дешевле обработать в одном потоке
+    const size_t kParallelThreshold = 64;
+    const size_t kParallelGrain = 32;
+
+    // Какой таймер идёт у призрака: строка - множители dt для полей
+    // GhostTimers (mode, release, frightened, unused)
+    enum TimerState { TIMERS_STOPPED, TIMERS_IN_PEN, TIMERS_FRIGHTENED, TIMERS_SCHEDULED };
+    alignas(16) const float kTimerSteps[4][4] = {
+        {0.0f, 0.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f, 0.0f},
+        {-1.0f, 0.0f, 0.0f, 0.0f},
+    };
+
+    inline TimerState timerState(const GhostBrain& brain) {
+        if (brain.eaten) return TIMERS_STOPPED;
+        if (!brain.released) return TIMERS_IN_PEN;
+        return brain.mode == kFrightened ? TIMERS_FRIGHTENED : TIMERS_SCHEDULED;
+    }
+
+    static_assert(sizeof(Position) == 2 * sizeof(Fixed) && sizeof(PreviousPosition) == sizeof(Position) &&
+                  sizeof(Velocity) == sizeof(Position), "advancePositions treats x, y pairs as a flat array");
+}
+
+size_t GhostSystem::add(int x, int y) {
+    // У каждого призрака свой генератор, чтобы решения не зависели от порядка потоков
+    uint32_t state = (seed + static_cast<uint32_t>(size() + 1) * 0x9E3779B9u) ^ 0x85EBCA6Bu;
+    const Position center{tileCenterFixed(x), tileCenterFixed(y)};
+
+    const size_t i = ghosts.add(Tile{x, y}, center, PreviousPosition{center.x, center.y}, Velocity{0, 0},
+                                Heading{static_cast<uint8_t>(Direction::UP)},
+                                GhostBrain{static_cast<uint8_t>(GhostMode::SCATTER), 0, 0, state ? state : 1u, x, y},
+                                GhostTimers{5.0f, 0.0f, 0.0f, 0.0f});
+    hash ^= tileKey(i) ^ modeKey(i);
+    return i;
+}
+
+void GhostSystem::clear() {
+    // Блоки архетипа сохраняются для следующего раунда
+    ghosts.clear();
+    hash = 0;
+    hashDelta.store(0, std::memory_order_relaxed);
+}
+
+void GhostSystem::think(float deltaTime, const Pacman* pacman, std::vector<std::string>& levelMap,
+                        JobSystem* jobs) {
+    if (size() == 0 || levelMap.empty()) return;
+
+    advanceTimers(deltaTime);
+
+    const std::vector<std::string>& sharedMap = levelMap;
+    if (jobs && size() >= kParallelThreshold) {
+        jobs->parallelFor(size(), kParallelGrain, [&](size_t begin, size_t end) {
+            thinkRange(begin, end, pacman, sharedMap);
+        });
+    } else {
+        thinkRange(0, size(), pacman, sharedMap);
+    }
+    commit(levelMap);
+}
+
+void GhostSystem::move(const std::vector<std::string>& levelMap) {
+    if (size() == 0 || levelMap.empty()) return;
+
+    updateVelocities(levelMap);
+    advancePositions();
+    resolvePositions(levelMap);
+}
+
+void GhostSystem::reverse(size_t i) {
+    uint8_t& dir = ghosts.get<Heading>(i).dir;
+    dir = static_cast<uint8_t>(oppositeDirection(static_cast<Direction>(dir)));
+}
+
+uint64_t GhostSystem::tileKey(size_t i) const {
+    const Tile& tile = ghosts.get<Tile>(i);
+    return zobristKey(ZobristKind::GHOST_TILE, static_cast<uint32_t>(i), tile.x, tile.y);
+}
+
+uint64_t GhostSystem::modeKey(size_t i) const {
+    return zobristKey(ZobristKind::GHOST_MODE, static_cast<uint32_t>(i), 0, 0, ghosts.get<GhostBrain>(i).mode);
+}
+
+uint64_t GhostSystem::setMode(size_t i, GhostMode newMode) {
+    const uint64_t before = modeKey(i);
+    ghosts.get<GhostBrain>(i).mode = static_cast<uint8_t>(newMode);
+    return before ^ modeKey(i);
+}
+
+bool GhostSystem::anyFrightened() const {
+    for (size_t chunk = 0; chunk < ghosts.chunkCount(); ++chunk) {
+        const GhostBrain* brain = ghosts.column<GhostBrain>(chunk);
+        for (size_t k = 0; k < ghosts.chunkLength(chunk); ++k) {
+            if (brain[k].mode == kFrightened) return true;
+        }
+    }
+    return false;
+}
+
+uint64_t GhostSystem::computeHash() const {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size(); ++i) {
+        result ^= tileKey(i) ^ modeKey(i);
+        if (ghosts.get<GhostBrain>(i).eaten) result ^= zobristKey(ZobristKind::GHOST_EATEN, static_cast<uint32_t>(i), 0, 0);
+    }
+    return result;
+}
+
+uint32_t GhostSystem::nextRandom(size_t i) {
+    // xorshift32
+    uint32_t& state = ghosts.get<GhostBrain>(i).rng;
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state = x;
+    return x;
+}
+
+void GhostSystem::advanceTimers(float deltaTime) {
+    for (size_t chunk = 0; chunk < ghosts.chunkCount(); ++chunk) {
+        const size_t n = ghosts.chunkLength(chunk);
+        const GhostBrain* brain = ghosts.column<GhostBrain>(chunk);
+        GhostTimers* timers = ghosts.column<GhostTimers>(chunk);
+
+#if defined(__SSE2__)
+        // Весь компонент за одну операцию: timers += step * dt
+        const __m128 dt = _mm_set1_ps(deltaTime);
+        for (size_t k = 0; k < n; ++k) {
+            const __m128 step = _mm_load_ps(kTimerSteps[timerState(brain[k])]);
+            _mm_store_ps(&timers[k].mode, _mm_add_ps(_mm_load_ps(&timers[k].mode), _mm_mul_ps(step, dt)));
+        }
+#else
+        for (size_t k = 0; k < n; ++k) {
+            switch (timerState(brain[k])) {
+                case TIMERS_IN_PEN:     timers[k].release += deltaTime; break;
+                case TIMERS_FRIGHTENED: timers[k].frightened -= deltaTime; break;
+                case TIMERS_SCHEDULED:  timers[k].mode -= deltaTime; break;
+                case TIMERS_STOPPED:    break;
+            }
+        }
+#endif
+    }
+}
+
+void GhostSystem::thinkRange(size_t begin, size_t end, const Pacman* pacman, const std::vector<std::string>& levelMap) {
+    uint64_t delta = 0;
+    for (size_t i = begin; i < end; ) {
+        // Диапазон задачи может начинаться и кончаться посреди блока
+        const size_t chunk = i / Ghosts::kChunkSize;
+        const size_t chunkEnd = std::min(end, (chunk + 1) * Ghosts::kChunkSize);
+        GhostBrain* brain = ghosts.column<GhostBrain>(chunk);
+        GhostTimers* timers = ghosts.column<GhostTimers>(chunk);
+        const Tile* tile = ghosts.column<Tile>(chunk);
+        const Position* pos = ghosts.column<Position>(chunk);
+
+        for (; i < chunkEnd; ++i) {
+            const size_t k = i % Ghosts::kChunkSize;
+            if (brain[k].eaten) continue;
+
+            if (!brain[k].released) {
+                if (timers[k].release >= 5.0f) {
+                    // Клетка откроется в фазе применения
+                    doorOpenRequested.store(true, std::memory_order_relaxed);
+                    brain[k].released = 1;
+                    delta ^= setMode(i, GhostMode::SCATTER);
+                    timers[k].mode = 7.0f;
+                }
+                continue;
+            }
+
+            if (brain[k].mode != kFrightened) {
+                if (timers[k].mode <= 0) {
+                    delta ^= setMode(i, brain[k].mode == static_cast<uint8_t>(GhostMode::CHASE)
+                                            ? GhostMode::SCATTER : GhostMode::CHASE);
+                    timers[k].mode = 5.0f;
+                    // Разворачиваем призрака при смене режима
+                    reverse(i);
+                }
+            }
+            else if (timers[k].frightened <= 0) {
+                delta ^= frighten(i, false);
+                timers[k].mode = 5.0f;
+            }
+
+            if (pos[k].x == tileCenterFixed(tile[k].x) && pos[k].y == tileCenterFixed(tile[k].y)) {
+                decide(i, pacman, levelMap);
+            }
+        }
+    }
+    if (delta) hashDelta.fetch_xor(delta, std::memory_order_relaxed);
+}
+
+void GhostSystem::commit(std::vector<std::string>& levelMap) {
+    hash ^= hashDelta.exchange(0, std::memory_order_relaxed);
+    if (doorOpenRequested.exchange(false, std::memory_order_relaxed)) {
+        // Открываем клетку
+        if (levelMap.size() > kDoorY && levelMap[kDoorY].size() > kDoorX) {
+            levelMap[kDoorY][kDoorX] = ' ';
+        }
+    }
+}
+
+void GhostSystem::decide(size_t i, const Pacman* pacman, const std::vector<std::string>& levelMap) {
+    const Tile& tile = ghosts.get<Tile>(i);
+    const uint8_t mode = ghosts.get<GhostBrain>(i).mode;
+    uint8_t& dir = ghosts.get<Heading>(i).dir;
+    const Direction current = static_cast<Direction>(dir);
+    unsigned exits = GameObject::exitsAt(tile.x, tile.y, levelMap);
+    unsigned forward = exits & ~directionBit(oppositeDirection(current));
+
+    // В режиме испуга - случайный выход, разворот только в тупике
+    if (mode == kFrightened) {
+        unsigned options = forward ? forward : exits;
+        if (options) {
+            dir = static_cast<uint8_t>(nthExit(options, nextRandom(i) % exitCount(options)));
+        }
+        return;
+    }
+
+    int targetTileX = 1;
+    int targetTileY = 1;
+    if (mode == static_cast<uint8_t>(GhostMode::CHASE) && pacman) {
+        targetTileX = pacman->getTileX();
+        targetTileY = pacman->getTileY();
+    }
+
+    if (!forward) {
+        if (!GameObject::canMoveFrom(tile.x, tile.y, current, levelMap)) {
+            dir = static_cast<uint8_t>(Direction::NONE);
+        }
+        return;
+    }
+
+    // Порядок перебора задаёт приоритет при равных расстояниях
+    static const Direction order[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    static const int stepX[4] = {0, 0, -1, 1};
+    static const int stepY[4] = {-1, 1, 0, 0};
+
+    int minDistance = INT_MAX;
+    int bestIndex = 0;
+
+    for (int k = 0; k < 4; ++k) {
+        bool legal = (forward & directionBit(order[k])) != 0;
+        int dist = abs(tile.x + stepX[k] - targetTileX) + abs(tile.y + stepY[k] - targetTileY);
+        dist = legal ? dist : INT_MAX;
+
+        bool better = dist < minDistance;
+        minDistance = better ? dist : minDistance;
+        bestIndex = better ? k : bestIndex;
+    }
+
+    dir = static_cast<uint8_t>(order[bestIndex]);
+}
+
+void GhostSystem::updateVelocities(const std::vector<std::string>& levelMap) {
+    for (size_t chunk = 0; chunk < ghosts.chunkCount(); ++chunk) {
+        const size_t n = ghosts.chunkLength(chunk);
+        const Tile* tile = ghosts.column<Tile>(chunk);
+        const Heading* heading = ghosts.column<Heading>(chunk);
+        const GhostBrain* brain = ghosts.column<GhostBrain>(chunk);
+        Velocity* velocity = ghosts.column<Velocity>(chunk);
+
+        for (size_t k = 0; k < n; ++k) {
+            // Съеденные призраки исчезают до перезапуска уровня и не двигаются
+            Fixed speed = 0;
+            if (brain[k].released && !brain[k].eaten) {
+                if (brain[k].mode == kFrightened) speed = speeds.frightened;
+                else if (GameObject::isTunnelTile(tile[k].x, tile[k].y, levelMap)) speed = speeds.tunnel;
+                else speed = speeds.normal;
+            }
+            velocity[k].x = speed * kStepX[heading[k].dir];
+            velocity[k].y = speed * kStepY[heading[k].dir];
+        }
+    }
+}
+
+void GhostSystem::advancePositions() {
+    for (size_t chunk = 0; chunk < ghosts.chunkCount(); ++chunk) {
+        // Пары x, y подряд: блок - плоские массивы из 2n координат
+        const size_t n = 2 * ghosts.chunkLength(chunk);
+        Fixed* pos = &ghosts.column<Position>(chunk)->x;
+        Fixed* prev = &ghosts.column<PreviousPosition>(chunk)->x;
+        const Fixed* vel = &ghosts.column<Velocity>(chunk)->x;
+        size_t i = 0;
+
+#if defined(__SSE2__)
+        for (; i + 4 <= n; i += 4) {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pos[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&prev[i]), p);
+            p = _mm_add_epi32(p, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&vel[i])));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&pos[i]), p);
+        }
+#endif
+
+        for (; i < n; ++i) {
+            prev[i] = pos[i];
+            pos[i] += vel[i];
+        }
+    }
+}
+
+void GhostSystem::resolvePositions(const std::vector<std::string>& levelMap) {
+    const Fixed mapWidth = toFixed(static_cast<int>(levelMap[0].size()) * 16);
+
+    for (size_t chunk = 0; chunk < ghosts.chunkCount(); ++chunk) {
+        const size_t n = ghosts.chunkLength(chunk);
+        Position* pos = ghosts.column<Position>(chunk);
+        const PreviousPosition* prev = ghosts.column<PreviousPosition>(chunk);
+        const Heading* heading = ghosts.column<Heading>(chunk);
+        Tile* tile = ghosts.column<Tile>(chunk);
+
+        for (size_t k = 0; k < n; ++k) {
+            if (pos[k].x == prev[k].x && pos[k].y == prev[k].y) continue;
+
+            // Туннель, дробная часть сохраняется
+            if (pos[k].x < 0) {
+                pos[k].x += mapWidth;
+            }
+            else if (pos[k].x >= mapWidth) {
+                pos[k].x -= mapWidth;
+            }
+            else {
+                // Пересекая центр тайла, призрак останавливается в нём,
+                // чтобы на следующем тике принять решение о повороте
+                Fixed cx = tileCenterFixed(fixedFloor(pos[k].x) / 16);
+                Fixed cy = tileCenterFixed(fixedFloor(pos[k].y) / 16);
+                switch (static_cast<Direction>(heading[k].dir)) {
+                    case Direction::RIGHT: if (prev[k].x < cx && pos[k].x >= cx) pos[k].x = cx; break;
+                    case Direction::LEFT:  if (prev[k].x > cx && pos[k].x <= cx) pos[k].x = cx; break;
+                    case Direction::DOWN:  if (prev[k].y < cy && pos[k].y >= cy) pos[k].y = cy; break;
+                    case Direction::UP:    if (prev[k].y > cy && pos[k].y <= cy) pos[k].y = cy; break;
+                    case Direction::NONE:  break;
+                }
+            }
+
+            const int32_t newTileX = fixedFloor(pos[k].x) / 16;
+            const int32_t newTileY = fixedFloor(pos[k].y) / 16;
+            if (newTileX != tile[k].x || newTileY != tile[k].y) {
+                const size_t i = chunk * Ghosts::kChunkSize + k;
+                hash ^= tileKey(i);
+                tile[k].x = newTileX;
+                tile[k].y = newTileY;
+                hash ^= tileKey(i);
+            }
+        }
+    }
+}
+
+uint64_t GhostSystem::frighten(size_t i, bool frightened) {
+    if (frightened) {
+        ghosts.get<GhostTimers>(i).frightened = frightenedSeconds;
+        reverse(i);
+        return setMode(i, GhostMode::FRIGHTENED);
+    }
+    return setMode(i, GhostMode::CHASE);
+}
+
+void GhostSystem::setFrightened(size_t i, bool frightened) {
+    hash ^= frighten(i, frightened);
+}
+
+void GhostSystem::setEaten(size_t i, bool value) {
+    uint8_t& eaten = ghosts.get<GhostBrain>(i).eaten;
+    if ((eaten != 0) == value) return;
+    eaten = value ? 1 : 0;
+    hash ^= zobristKey(ZobristKind::GHOST_EATEN, static_cast<uint32_t>(i), 0, 0);
+}
+
+void GhostSystem::changeMode(size_t i, GhostMode newMode) {
+    const GhostBrain& brain = ghosts.get<GhostBrain>(i);
+    if (newMode != GhostMode::FRIGHTENED) {
+        ghosts.get<GhostTimers>(i).mode = 0.0f;
+    }
+    if (static_cast<uint8_t>(newMode) != brain.mode && !brain.eaten) {
+        reverse(i);
+    }
+    hash ^= setMode(i, newMode);
+}
+
+void GhostSystem::setPosition(size_t i, int newTileX, int newTileY) {
+    hash ^= tileKey(i);
+    ghosts.get<Tile>(i) = Tile{newTileX, newTileY};
+    hash ^= tileKey(i);
+    const Position center{tileCenterFixed(newTileX), tileCenterFixed(newTileY)};
+    ghosts.get<Position>(i) = center;
+    ghosts.get<PreviousPosition>(i) = PreviousPosition{center.x, center.y};
+    ghosts.get<Heading>(i).dir = static_cast<uint8_t>(Direction::NONE);
+}
+
+void GhostSystem::resetToStart(size_t i) {
+    GhostBrain& brain = ghosts.get<GhostBrain>(i);
+    setPosition(i, brain.spawnX, brain.spawnY);
+    brain.released = 0;
+    ghosts.get<GhostTimers>(i).release = 0.0f;
+    changeMode(i, GhostMode::SCATTER);
+}
+
+void GhostSystem::saveState(std::vector<uint8_t>& out) const {
+    putVarint(out, size());
+    for (size_t i = 0; i < size(); ++i) {
+        const Tile& tile = ghosts.get<Tile>(i);
+        const Position& pos = ghosts.get<Position>(i);
+        const PreviousPosition& prev = ghosts.get<PreviousPosition>(i);
+        const Velocity& vel = ghosts.get<Velocity>(i);
+        const GhostBrain& brain = ghosts.get<GhostBrain>(i);
+        const GhostTimers& timers = ghosts.get<GhostTimers>(i);
+        putSigned(out, tile.x);
+        putSigned(out, tile.y);
+        putSigned(out, pos.x);
+        putSigned(out, pos.y);
+        putSigned(out, prev.x);
+        putSigned(out, prev.y);
+        putSigned(out, vel.x);
+        putSigned(out, vel.y);
+        putFloat(out, timers.mode);
+        putFloat(out, timers.release);
+        putFloat(out, timers.frightened);
+        out.push_back(ghosts.get<Heading>(i).dir);
+        out.push_back(brain.mode);
+        out.push_back(static_cast<uint8_t>(brain.released | (brain.eaten << 1)));
+        putVarint(out, brain.rng);
+    }
+}
+
+bool GhostSystem::restoreState(ByteReader& in) {
+    size_t count;
+    if (!in.varint(count) || count != size()) return false;
+    for (size_t i = 0; i < count; ++i) {
+        Tile& tile = ghosts.get<Tile>(i);
+        Position& pos = ghosts.get<Position>(i);
+        PreviousPosition& prev = ghosts.get<PreviousPosition>(i);
+        Velocity& vel = ghosts.get<Velocity>(i);
+        GhostBrain& brain = ghosts.get<GhostBrain>(i);
+        GhostTimers& timers = ghosts.get<GhostTimers>(i);
+        uint8_t& dir = ghosts.get<Heading>(i).dir;
+        uint8_t flags;
+        if (!in.signedVarint(tile.x) || !in.signedVarint(tile.y) ||
+            !in.signedVarint(pos.x) || !in.signedVarint(pos.y) ||
+            !in.signedVarint(prev.x) || !in.signedVarint(prev.y) ||
+            !in.signedVarint(vel.x) || !in.signedVarint(vel.y) ||
+            !in.floatValue(timers.mode) || !in.floatValue(timers.release) || !in.floatValue(timers.frightened) ||
+            !in.byte(dir) || !in.byte(brain.mode) || !in.byte(flags) || !in.varint(brain.rng)) {
+            return false;
+        }
+        if (dir > static_cast<uint8_t>(Direction::NONE) || brain.mode > static_cast<uint8_t>(GhostMode::EATEN)) {
+            return false;
+        }
+        brain.released = flags & 1;
+        brain.eaten = (flags >> 1) & 1;
+    }
+    hash = computeHash();
+    return true;
+}
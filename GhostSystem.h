@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Archetype.h"
+#include "Characters.h"
+#include "Components.h"
+#include "Zobrist.h"
+
+class JobSystem;
+
+// Все призраки уровня - сущности одного архетипа (Archetype): тайл,
+// позиция, скорость, направление, ИИ и таймеры лежат плотными массивами по
+// блокам. Таймеры и координаты (16.16, см. FixedPoint.h) продвигаются
+// векторными циклами (SSE2), решения ИИ принимаются только в центре тайла.
+// Объекты Ghost остаются игровыми сущностями для отрисовки и столкновений и
+// читают своё состояние отсюда по индексу.
+//
+// Решения ИИ читают только общую карту, позицию Пакмана и состояние своего
+// призрака, поэтому при наличии JobSystem выполняются параллельно. Запись
+// в общее состояние (открытие клетки) откладывается до фазы применения.
+class GhostSystem {
+public:
+    // Клетка двери загона, которую открывает первый выпущенный призрак
+    static const int kDoorX = 9;
+    static const int kDoorY = 9;
+
+    size_t add(int tileX, int tileY);
+    void clear();
+    size_t size() const { return ghosts.size(); }
+    void setSeed(uint32_t newSeed) { seed = newSeed; }
+    // Правила уровня: скорости и длительность испуга от энерджайзера
+    void setSpeeds(const SpeedTable& table) { speeds = table; }
+    void setFrightenedSeconds(float seconds) { frightenedSeconds = seconds; }
+
+    // Системы тика (см. TickPhase в Level.h). think - таймеры и решения ИИ,
+    // единственная запись в карту - открытие двери загона; jobs == nullptr -
+    // всё выполняется в вызывающем потоке. move - шаг движения
+    void think(float deltaTime, const Pacman* pacman, std::vector<std::string>& levelMap,
+               JobSystem* jobs = nullptr);
+    void move(const std::vector<std::string>& levelMap);
+
+    int getTileX(size_t i) const { return ghosts.get<Tile>(i).x; }
+    int getTileY(size_t i) const { return ghosts.get<Tile>(i).y; }
+    int getPixelX(size_t i) const { return fixedFloor(ghosts.get<Position>(i).x); }
+    int getPixelY(size_t i) const { return fixedFloor(ghosts.get<Position>(i).y); }
+    Fixed getPosX(size_t i) const { return ghosts.get<Position>(i).x; }
+    Fixed getPosY(size_t i) const { return ghosts.get<Position>(i).y; }
+    Direction getDirection(size_t i) const { return static_cast<Direction>(ghosts.get<Heading>(i).dir); }
+    GhostMode getMode(size_t i) const { return static_cast<GhostMode>(ghosts.get<GhostBrain>(i).mode); }
+    bool getIsReleased(size_t i) const { return ghosts.get<GhostBrain>(i).released != 0; }
+    bool getIsEaten(size_t i) const { return ghosts.get<GhostBrain>(i).eaten != 0; }
+    float getFrightenedTimer(size_t i) const { return ghosts.get<GhostTimers>(i).frightened; }
+    // Хотя бы один призрак испуган: энерджайзер ещё действует
+    bool anyFrightened() const;
+
+    void setEaten(size_t i, bool value);
+    void setFrightened(size_t i, bool frightened);
+    void changeMode(size_t i, GhostMode newMode);
+    void setPosition(size_t i, int newTileX, int newTileY);
+    void resetToStart(size_t i);
+
+    // Всё состояние призраков для ключевых кадров повтора. Восстанавливается
+    // поверх системы того же уровня (число призраков и точки появления те же)
+    void saveState(std::vector<uint8_t>& out) const;
+    bool restoreState(ByteReader& in);
+
+    // Хэш Зобриста призраков: тайл, режим и съеденность каждого (Zobrist.h).
+    // Ведётся по ходу изменений, в том числе из параллельной фазы ИИ
+    uint64_t getHash() const { return hash; }
+    // Тот же хэш, посчитанный заново по всем призракам - для проверки
+    uint64_t computeHash() const;
+    const PoolStats& getStats() const { return ghosts.getStats(); }
+
+private:
+    using Ghosts = Archetype<64, Tile, Position, PreviousPosition, Velocity, Heading, GhostBrain, GhostTimers>;
+    Ghosts ghosts;
+    uint32_t seed = 1;
+    SpeedTable speeds = kGhostSpeeds;
+    float frightenedSeconds = 5.0f;
+
+    uint64_t hash = 0;
+
+    // Запросы к общему состоянию, накопленные параллельной фазой
+    std::atomic<bool> doorOpenRequested{false};
+    std::atomic<uint64_t> hashDelta{0};
+
+    void reverse(size_t i);
+    uint64_t tileKey(size_t i) const;
+    uint64_t modeKey(size_t i) const;
+    // Меняют режим и возвращают изменение хэша: в параллельной фазе оно
+    // копится отдельно и применяется в commit
+    uint64_t setMode(size_t i, GhostMode newMode);
+    uint64_t frighten(size_t i, bool frightened);
+    uint32_t nextRandom(size_t i);
+    void advanceTimers(float deltaTime);
+    void thinkRange(size_t begin, size_t end, const Pacman* pacman, const std::vector<std::string>& levelMap);
+    void commit(std::vector<std::string>& levelMap);
+    void decide(size_t i, const Pacman* pacman, const std::vector<std::string>& levelMap);
+    void updateVelocities(const std::vector<std::string>& levelMap);
+    void advancePositions();
+    void resolvePositions(const std::vector<std::string>& levelMap);
+};
@@ -0,0 +1,135 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+bool JobSystem::WorkerQueue::push(const Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == kQueueCapacity) return false;
+    jobs[(head + count) % kQueueCapacity] = job;
+    count++;
+    return true;
+}
+
+bool JobSystem::WorkerQueue::popBack(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) return false;
+    count--;
+    job = jobs[(head + count) % kQueueCapacity];
+    return true;
+}
+
+bool JobSystem::WorkerQueue::stealFront(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) return false;
+    job = jobs[head];
+    head = (head + 1) % kQueueCapacity;
+    count--;
+    return true;
+}
+
+JobSystem::JobSystem(unsigned workerCount) {
+    if (workerCount == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 1;
+    }
+
+    for (unsigned i = 0; i < workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::execute(const Job& job) {
+    job.function(job.context, job.begin, job.end);
+    job.pending->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool JobSystem::steal(size_t thief, Job& job) {
+    for (size_t k = 1; k <= queues.size(); ++k) {
+        if (queues[(thief + k) % queues.size()]->stealFront(job)) {
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::run(size_t count, size_t grain, JobFunction function, void* context) {
+    if (count == 0) return;
+
+    grain = std::max<size_t>(grain, 1);
+    const size_t capacity = queues.size() * kQueueCapacity;
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks > capacity) {
+        chunks = capacity;
+        grain = (count + chunks - 1) / chunks;
+    }
+
+    if (chunks <= 1 || queues.empty()) {
+        function(context, 0, count);
+        return;
+    }
+
+    std::atomic<size_t> pending{0};
+    size_t submitted = 0;
+    for (size_t begin = 0; begin < count; begin += grain) {
+        Job job{function, context, begin, std::min(count, begin + grain), &pending};
+        pending.fetch_add(1, std::memory_order_relaxed);
+        queuedJobs.fetch_add(1, std::memory_order_relaxed);
+        if (queues[submitted % queues.size()]->push(job)) {
+            submitted++;
+        } else {
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            function(context, job.begin, job.end);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wakeCondition.notify_all();
+
+    // Вызывающий поток тоже крадёт работу, пока не выполнены все части
+    Job job;
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (steal(queues.size() - 1, job)) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(size_t index) {
+    Job job;
+    while (true) {
+        if (queues[index]->popBack(job)) {
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            execute(job);
+            continue;
+        }
+        if (steal(index, job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.wait(lock, [this] {
+            return stopping || queuedJobs.load(std::memory_order_relaxed) > 0;
+        });
+        if (stopping) return;
+    }
+}
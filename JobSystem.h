@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Небольшая система задач с кражей работы. У каждого рабочего потока своя
+// очередь фиксированного размера: владелец берёт задачи с конца, остальные
+// потоки (и вызывающий поток) крадут с начала. parallelFor блокирует
+// вызывающего до завершения всех частей и сам участвует в работе.
+class JobSystem {
+public:
+    // workerCount == 0 - по числу ядер минус вызывающий поток
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned getWorkerCount() const { return static_cast<unsigned>(workers.size()); }
+
+    // Вызывает fn(begin, end) для диапазонов из [0, count) размером не меньше grain
+    template <typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        using Functor = typename std::remove_reference<Fn>::type;
+        run(count, grain, [](void* context, size_t begin, size_t end) {
+            (*static_cast<Functor*>(context))(begin, end);
+        }, &fn);
+    }
+
+private:
+    using JobFunction = void (*)(void* context, size_t begin, size_t end);
+
+    struct Job {
+        JobFunction function = nullptr;
+        void* context = nullptr;
+        size_t begin = 0;
+        size_t end = 0;
+        std::atomic<size_t>* pending = nullptr;
+    };
+
+    static const size_t kQueueCapacity = 256;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        Job jobs[kQueueCapacity];
+        size_t head = 0;
+        size_t count = 0;
+
+        bool push(const Job& job);
+        bool popBack(Job& job);
+        bool stealFront(Job& job);
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<size_t> queuedJobs{0};
+    bool stopping = false;
+
+    void run(size_t count, size_t grain, JobFunction function, void* context);
+    void workerLoop(size_t index);
+    bool steal(size_t thief, Job& job);
+    static void execute(const Job& job);
+};
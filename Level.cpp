@@ -1,228 +1,451 @@
 #include "Level.h"
-#include <fstream>
+#include "AssetManager.h"
+#include "FrameRenderer.h"
+#include "StateStream.h"
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
-Level::Level(SDL_Renderer* renderer) : renderer(renderer) {
-    if (!renderer) throw std::runtime_error("Null renderer");
-    font = TTF_OpenFont("fonts/arial.ttf", 24);
-    if (!font) {
-        std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
+namespace {
+    // Клетка, в которую попадает пиксель, в том числе левее карты (туннель)
+    inline int floorTile(int pixel) {
+        return pixel >= 0 ? pixel / 16 : (pixel - 15) / 16;
+    }
+
+    void splitLayout(const std::string& text, std::vector<std::string>& rows) {
+        rows.clear();
+        std::istringstream file(text);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) rows.push_back(line);
+        }
+    }
+
+    bool sameGhostSpawns(const std::vector<std::string>& a, const std::vector<std::string>& b) {
+        for (size_t y = 0; y < a.size(); ++y) {
+            for (size_t x = 0; x < a[y].size(); ++x) {
+                if ((a[y][x] == 'G') != (b[y][x] == 'G')) return false;
+            }
+        }
+        return true;
     }
 }
 
-Level::~Level() {
-    if (font) {
-        TTF_CloseFont(font);
-        font = nullptr;
+Level::Level(SDL_Renderer* renderer, AssetManager& assets) : renderer(renderer), assets(assets) {
+    eatenFruits.reserve(8);
+    fruitIcons = std::make_unique<FruitIcons>(renderer, assets);
+    if (renderer) {
+        frameRenderer = std::make_unique<FrameRenderer>(renderer, assets);
     }
+}
+
+Level::~Level() {
     layout.clear();
-    game_objects.clear();
+    clearEntities();
     std::cout << "Level destroyed" << std::endl;
 }
 
-bool Level::loadFromFile(const std::string& path) {
-    layout.clear();
-    game_objects.clear();
-    pacman.reset();
+void Level::clearEntities() {
+    // Указатели сбрасываются до очистки пулов, ёмкость векторов сохраняется.
+    // Клетки и предметы PickupSystem заменяет reset при постройке раунда
+    levelGhosts.clear();
+    ghosts.clear();
+    ghostSystem.clear();
+}
 
-    std::ifstream file(path);
-    if (!file) {
+bool Level::loadFromFile(const std::string& path) {
+    std::string text;
+    if (!assets.readText(path, text)) {
         std::cerr << "Error: Failed to open " << path << "\n";
         return false;
     }
+    loadFromText(path, text);
+    return true;
+}
+
+void Level::loadFromText(const std::string& path, const std::string& text) {
+    levelPath = path;
+    levelText = text;
+    splitLayout(text, fileLayout);
+    parseLayout();
+    buildFromLayout();
+}
+
+int Level::reloadFromText(const std::string& text) {
+    std::vector<std::string> newLayout;
+    splitLayout(text, newLayout);
+    levelText = text;
+
+    // Размеры карты задают сетку точек, клетки 'G' - призраков в пуле и
+    // GhostSystem: если они другие, по месту карту не поменять
+    bool sameShape = newLayout.size() == fileLayout.size();
+    for (size_t y = 0; sameShape && y < newLayout.size(); ++y) {
+        sameShape = newLayout[y].size() == fileLayout[y].size();
+    }
+    if (!sameShape || !sameGhostSpawns(fileLayout, newLayout)) {
+        fileLayout.swap(newLayout);
+        parseLayout();
+        restartLevel(true);
+        return -1;
+    }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (!line.empty()) layout.push_back(line);
+    int changed = 0;
+    for (int y = 0; y < getGridHeight(); ++y) {
+        for (int x = 0; x < static_cast<int>(fileLayout[y].size()); ++x) {
+            const char after = newLayout[y][x];
+            if (fileLayout[y][x] == after) continue;
+            changed++;
+            // Клетка из файла заменяет и открытую по ходу игры (дверь загона)
+            layout[y][x] = after;
+            // Точки, которых в файле не трогали, остаются съеденными или нет
+            const int cell = y * gridWidth + x;
+            if (pickups.kindAt(cell) != PELLET_NONE) pickups.removeCell(cell);
+            if (const PelletKind kind = pelletKindFor(after)) pickups.addCell(cell, kind);
+        }
+    }
+    fileLayout.swap(newLayout);
+    if (changed == 0) return 0;
+    parseLayout();
+
+    // Кто оказался в стене - на точку появления, остальные не трогаются
+    auto walled = [this](int x, int y) {
+        return y >= 0 && y < getGridHeight() && x >= 0 && x < static_cast<int>(layout[y].size()) &&
+               layout[y][x] == '#';
+    };
+    if (pacman && walled(pacman->getTileX(), pacman->getTileY())) respawnPacman();
+    for (size_t i = 0; i < ghostSystem.size(); ++i) {
+        if (walled(ghostSystem.getTileX(i), ghostSystem.getTileY(i))) ghostSystem.resetToStart(i);
     }
 
-    bool pacman_created = false;
-    for (int y = 0; y < layout.size(); ++y) {
-        for (int x = 0; x < layout[y].size(); ++x) {
-            const char c = layout[y][x];
+    pelletVersion++;
+    rehash();
+    return changed;
+}
+
+void Level::parseLayout() {
+    gridWidth = 0;
+    for (const auto& row : fileLayout) {
+        gridWidth = std::max(gridWidth, static_cast<int>(row.size()));
+    }
+    startPellets.assign(fileLayout.size() * gridWidth, PELLET_NONE);
+    startPelletHash = 0;
+    startPacmanX = startPacmanY = -1;
+    ghostSpawns.clear();
+
+    for (int y = 0; y < fileLayout.size(); ++y) {
+        for (int x = 0; x < fileLayout[y].size(); ++x) {
+            const char c = fileLayout[y][x];
             switch (c) {
-                case 'P': 
-                    if (!pacman_created) {
-                        pacman = std::make_unique<Pacman>(x, y, renderer);
-                        pacman_created = true;
-                        std::cout << "Pacman CREATED at (" << x << "," << y << ")\n";
+                case 'P':
+                    if (startPacmanX < 0) {
+                        startPacmanX = x;
+                        startPacmanY = y;
                     }
                     break;
-                    
+
                 case 'G':
-                    game_objects.push_back(std::make_unique<Ghost>(x, y, renderer));
-                    break;
-                    
-                case '.':
-                    game_objects.push_back(std::make_unique<Dot>(x, y, renderer));
+                    ghostSpawns.emplace_back(x, y);
                     break;
-                    
-                case 'o':
-                    game_objects.push_back(std::make_unique<Energizer>(x, y, renderer));
+
+                default:
+                    if (const PelletKind kind = pelletKindFor(c)) {
+                        startPellets[y * gridWidth + x] = kind;
+                        startPelletHash ^= zobristKey(ZobristKind::PELLET, 0, x, y, kind);
+                    }
                     break;
             }
         }
     }
+}
+
+void Level::buildFromLayout(bool keepPacman) {
+    layout = fileLayout;
+    clearEntities();
+    if (!keepPacman) pacman.reset();
+
+    pickups.reset(gridWidth, startPellets);
+    pelletVersion++;
+
+    if (!pacman && startPacmanX >= 0) {
+        pacman = std::make_unique<Pacman>(startPacmanX, startPacmanY, renderer, assets);
+        std::cout << "Pacman CREATED at (" << startPacmanX << "," << startPacmanY << ")\n";
+    }
+    for (const auto& spawn : ghostSpawns) {
+        Ghost* ghost = ghosts.create(spawn.first, spawn.second, renderer, assets);
+        ghost->attach(&ghostSystem, ghostSystem.add(spawn.first, spawn.second));
+        levelGhosts.push_back(ghost);
+    }
 
     if (!pacman) {
         std::cerr << "Warning: No Pacman in level! Creating default...\n";
-        pacman = std::make_unique<Pacman>(1, 1, renderer);
+        pacman = std::make_unique<Pacman>(1, 1, renderer, assets);
     }
+    applyRules();
 
-    return true;
+    // Карта совпадает с файлом, в хэше только точки и клетка Пакмана
+    stateHash = startPelletHash;
+    hashedPacmanX = pacman->getTileX();
+    hashedPacmanY = pacman->getTileY();
+    stateHash ^= zobristKey(ZobristKind::PACMAN, 0, hashedPacmanX, hashedPacmanY);
+}
+
+void Level::setRules(const LevelRules& newRules) {
+    rules = newRules;
+    applyRules();
+}
+
+void Level::applyRules() {
+    if (pacman) pacman->setSpeeds(scaleSpeeds(kPacmanSpeeds, rules.speedPercent));
+    ghostSystem.setSpeeds(scaleSpeeds(kGhostSpeeds, rules.speedPercent));
+    ghostSystem.setFrightenedSeconds(rules.frightenedSeconds);
+}
+
+void Level::continueFrom(const Level& previous) {
+    if (pacman && previous.pacman) {
+        pacman->setLives(previous.pacman->getLives());
+        pacman->setScore(previous.pacman->getScore());
+    }
+    round = previous.round;
+    eatenFruits = previous.eatenFruits;
+    fruitIcons->invalidateStrip();
+    // Версия точек продолжает расти: слой точек не спутает новую карту со старой
+    pelletVersion = previous.pelletVersion + 1;
+}
+
+uint64_t Level::pelletKey(int cell) const {
+    return zobristKey(ZobristKind::PELLET, 0, cell % gridWidth, cell / gridWidth, pickups.kindAt(cell));
+}
+
+uint64_t Level::cellKey(int x, int y) const {
+    // Клетки, совпадающие с файлом, в хэш не входят
+    const char c = layout[y][x];
+    return c == fileLayout[y][x] ? 0 : zobristKey(ZobristKind::CELL, 0, x, y, static_cast<uint8_t>(c));
+}
+
+uint64_t Level::computeOwnHash() const {
+    uint64_t hash = 0;
+    for (int y = 0; y < getGridHeight(); ++y) {
+        for (int x = 0; x < static_cast<int>(layout[y].size()); ++x) {
+            const int cell = y * gridWidth + x;
+            if (pickups.kindAt(cell) != PELLET_NONE) hash ^= pelletKey(cell);
+            hash ^= cellKey(x, y);
+        }
+    }
+    if (pacman) hash ^= zobristKey(ZobristKind::PACMAN, 0, pacman->getTileX(), pacman->getTileY());
+    return hash;
+}
+
+void Level::rehash() {
+    stateHash = computeOwnHash();
+    hashedPacmanX = pacman ? pacman->getTileX() : 0;
+    hashedPacmanY = pacman ? pacman->getTileY() : 0;
+}
+
+void Level::updatePacmanHash() {
+    if (pacman->getTileX() == hashedPacmanX && pacman->getTileY() == hashedPacmanY) return;
+    stateHash ^= zobristKey(ZobristKind::PACMAN, 0, hashedPacmanX, hashedPacmanY);
+    hashedPacmanX = pacman->getTileX();
+    hashedPacmanY = pacman->getTileY();
+    stateHash ^= zobristKey(ZobristKind::PACMAN, 0, hashedPacmanX, hashedPacmanY);
 }
 
 void Level::update(float deltaTime) {
+    advance(deltaTime);
+    publishState();
+}
+
+// Строки идут по фазам (TickPhase), внутри фазы - в порядке выполнения
+const Level::TickSystem Level::kTickSystems[] = {
+    {TickPhase::PLAYER, &Level::movePacman},
+    {TickPhase::PICKUP, &Level::eatPellets},
+    {TickPhase::PICKUP, &Level::updateFruit},
+    {TickPhase::AI, &Level::thinkGhosts},
+    {TickPhase::MOVEMENT, &Level::moveGhosts},
+    {TickPhase::COLLISION, &Level::resolveGhostCollisions},
+    {TickPhase::RULES, &Level::checkRoundEnd},
+    {TickPhase::RULES, &Level::finishTick},
+};
+
+void Level::advance(float deltaTime) {
     if (!pacman || !pacman->getIsActive()) return;
 
+    for (const TickSystem& system : kTickSystems) {
+        (this->*system.run)(deltaTime);
+    }
+}
+
+void Level::movePacman(float deltaTime) {
     pacman->update(deltaTime);
-    pacman->move(deltaTime, layout);
-
-    // Обработка точек и энерджайзеров
-    for (auto it = game_objects.begin(); it != game_objects.end(); ) {
-        if (auto dot = dynamic_cast<Dot*>(it->get())) {
-            if (pacman->checkCollision(*dot)) {
-                pacman->addScore(10);
-                dotsEaten++;
-                it = game_objects.erase(it);
-                
-                // Проверка условий появления фруктов
-                if ((dotsEaten == 70 && !firstFruitSpawned) || 
-                    (dotsEaten == 170 && !secondFruitSpawned)) {
-                    spawnFruit();
-                    if (dotsEaten == 70) firstFruitSpawned = true;
-                    else secondFruitSpawned = true;
-                }
-                continue;
-            }
-        }
-        else if (auto energizer = dynamic_cast<Energizer*>(it->get())) {
-            if (pacman->checkCollision(*energizer)) {
-                pacman->addScore(50);
-                dotsEaten++;
-                for (auto& obj : game_objects) {
-                    if (auto ghost = dynamic_cast<Ghost*>(obj.get())) {
-                        ghost->setFrightened(true);
-                    }
-                }
-                it = game_objects.erase(it);
-                
-                if ((dotsEaten == 70 && !firstFruitSpawned) || 
-                    (dotsEaten == 170 && !secondFruitSpawned)) {
-                    spawnFruit();
-                    if (dotsEaten == 70) firstFruitSpawned = true;
-                    else secondFruitSpawned = true;
-                }
-                continue;
-            }
-        }
-        ++it;
-    }
-
-    updateFruit(deltaTime);
-
-    // Обработка столкновений с призраком
-    for (auto& obj : game_objects) {
-        if (auto ghost = dynamic_cast<Ghost*>(obj.get())) {
-            ghost->update(deltaTime, pacman.get(), layout);
-            
-            if (ghost->getIsReleased() && pacman->checkCollision(*ghost) && !ghost->getIsEaten()) {
-                if (ghost->getMode() == GhostMode::FRIGHTENED) {
-                    ghost->setEaten(true);
-                    pacman->addScore(200);
-                } else {
-                    pacman->loseLives();
-                    resetPositions();
-                    if (pacman->getLives() <= 0) {
-                        gameOverFlag = true;
-                    }
-                    break;
+    pacman->move(layout);
+}
+
+void Level::thinkGhosts(float deltaTime) {
+    // Дверь загона - единственная клетка карты, которую меняет тик
+    const bool hasDoor = getGridHeight() > GhostSystem::kDoorY &&
+                         static_cast<int>(layout[GhostSystem::kDoorY].size()) > GhostSystem::kDoorX;
+    const uint64_t doorBefore = hasDoor ? cellKey(GhostSystem::kDoorX, GhostSystem::kDoorY) : 0;
+    ghostSystem.think(deltaTime, pacman.get(), layout, jobs);
+    if (hasDoor) stateHash ^= doorBefore ^ cellKey(GhostSystem::kDoorX, GhostSystem::kDoorY);
+}
+
+void Level::moveGhosts(float deltaTime) {
+    ghostSystem.move(layout);
+}
+
+void Level::finishTick(float deltaTime) {
+    // Пакман заряжен, пока действует энерджайзер, то есть пока испуган
+    // хоть один призрак; от этого зависит его скорость на следующем тике
+    pacman->activatePower(ghostSystem.anyFrightened());
+    updatePacmanHash();
+}
+
+void Level::resolveGhostCollisions(float deltaTime) {
+    // Выполняется последовательно после параллельного ИИ, так как меняет
+    // счёт, жизни и позиции всех сущностей
+    for (Ghost* ghost : levelGhosts) {
+        ghost->syncFromSystem();
+
+        if (ghost->getIsReleased() && pacman->checkCollision(*ghost) && !ghost->getIsEaten()) {
+            if (ghost->getMode() == GhostMode::FRIGHTENED) {
+                ghost->setEaten(true);
+                pacman->addScore(200);
+            } else {
+                pacman->loseLives();
+                resetPositions();
+                if (pacman->getLives() <= 0) {
+                    gameOverFlag = true;
                 }
+                break;
             }
         }
     }
-    bool allGhostsEaten = true;
-    bool allDotsEaten = true;
-    
-    for (auto& obj : game_objects) {
-        if (auto ghost = dynamic_cast<Ghost*>(obj.get())) {
-            if (!ghost->getIsEaten()) {
-                allGhostsEaten = false;
-            }
-        }
-        else if (dynamic_cast<Dot*>(obj.get()) || dynamic_cast<Energizer*>(obj.get())) {
-            allDotsEaten = false;
-        }
-    }
+}
+
+void Level::checkRoundEnd(float deltaTime) {
+    bool allGhostsEaten = std::all_of(levelGhosts.begin(), levelGhosts.end(),
+                                      [](const Ghost* ghost) { return ghost->getIsEaten(); });
+    bool allDotsEaten = pickups.cellCount() == 0;
 
     if (allDotsEaten || allGhostsEaten) {
+        if (allDotsEaten) round++;
+        if (allDotsEaten && holdClearedRound) {
+            roundCleared = true;
+            return;
+        }
         restartLevel(true);
     }
 }
 
-void Level::renderText(const std::string& text, int x, int y, SDL_Color color) {
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Rect rect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, nullptr, &rect);
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+void Level::publishState() {
+    if (!stateStream) return;
+    captureState(stateStream->beginFrame());
+    stateStream->publish();
 }
 
-void Level::render() {
-    renderMaze();
-
-    for (auto& obj : game_objects) {
-        if (dynamic_cast<Dot*>(obj.get()) || dynamic_cast<Energizer*>(obj.get())) {
-            obj->render(renderer);
+void Level::captureState(StreamState& state) const {
+    const int height = getGridHeight();
+    state.width = gridWidth;
+    state.height = height;
+    state.cells.resize(static_cast<size_t>(gridWidth) * height);
+    for (int y = 0; y < height; ++y) {
+        const std::string& row = layout[y];
+        for (int x = 0; x < gridWidth; ++x) {
+            const int cell = y * gridWidth + x;
+            const bool wall = x < static_cast<int>(row.size()) && row[x] == '#';
+            state.cells[cell] = static_cast<uint8_t>(wall ? STREAM_WALL : kPickupRules[pickups.kindAt(cell)].cell);
         }
     }
 
-    if (currentFruit) {
-        std::cout << "Rendering fruit at (" 
-                  << currentFruit->getTileX() << "," 
-                  << currentFruit->getTileY() << ")" << std::endl;
-        currentFruit->render(renderer);
+    state.score = pacman ? pacman->getScore() : 0;
+    state.lives = pacman ? pacman->getLives() : 0;
+    state.entities.resize(1 + ghostSystem.size());
+    StreamEntity& hero = state.entities[0];
+    hero = {};
+    if (pacman) {
+        hero.x = static_cast<int16_t>(pacman->getPixelX());
+        hero.y = static_cast<int16_t>(pacman->getPixelY());
+        hero.dir = static_cast<uint8_t>(pacman->getDirection());
+        hero.flags = static_cast<uint8_t>((pacman->getIsActive() ? STREAM_ACTIVE : 0) |
+                                          (pacman->getIsPowered() ? STREAM_POWERED : 0));
     }
-
-    if (pacman && pacman->getIsActive()) {
-        pacman->render(renderer);
+    for (size_t i = 0; i < ghostSystem.size(); ++i) {
+        StreamEntity& ghost = state.entities[1 + i];
+        ghost.x = static_cast<int16_t>(ghostSystem.getPixelX(i));
+        ghost.y = static_cast<int16_t>(ghostSystem.getPixelY(i));
+        ghost.dir = static_cast<uint8_t>(ghostSystem.getDirection(i));
+        ghost.flags = static_cast<uint8_t>((ghostSystem.getIsReleased(i) ? STREAM_ACTIVE : 0) |
+                                           (ghostSystem.getIsEaten(i) ? STREAM_EATEN : 0) |
+                                           (static_cast<unsigned>(ghostSystem.getMode(i)) << STREAM_MODE_SHIFT));
     }
+}
 
-    for (auto& obj : game_objects) {
-        if (auto ghost = dynamic_cast<Ghost*>(obj.get())) {
-            if (!ghost->getIsEaten() && ghost->getIsActive()) {
-                ghost->render(renderer);
+void Level::eatPellets(float deltaTime) {
+    // Хитбокс Пакмана 16x16 задевает не больше четырёх клеток. Порядок
+    // обхода построчный, как у объектов в game_objects
+    const SDL_Rect box = pacman->getHitbox();
+    const int x0 = floorTile(box.x), x1 = floorTile(box.x + box.w - 1);
+    const int y0 = floorTile(box.y), y1 = floorTile(box.y + box.h - 1);
+
+    for (int y = std::max(y0, 0); y <= y1 && y < getGridHeight(); ++y) {
+        for (int x = std::max(x0, 0); x <= x1 && x < gridWidth; ++x) {
+            const int cell = y * gridWidth + x;
+            if (pickups.kindAt(cell) != PELLET_NONE) {
+                eatPellet(cell);
             }
         }
     }
+}
 
-    renderEatenFruits();
+void Level::eatPellet(int cell) {
+    const Pickup pickup = pickups.cellPickup(cell);
+    pacman->addScore(pickup.points);
+    if (kPickupRules[pickup.kind].frightensGhosts) {
+        for (size_t i = 0; i < ghostSystem.size(); ++i) {
+            ghostSystem.setFrightened(i, true);
+        }
+    }
+    removePellet(cell);
+    dotsEaten++;
+
+    // Проверка условий появления фруктов
+    if ((dotsEaten == 70 && !firstFruitSpawned) ||
+        (dotsEaten == 170 && !secondFruitSpawned)) {
+        spawnFruit();
+        if (dotsEaten == 70) firstFruitSpawned = true;
+        else secondFruitSpawned = true;
+    }
+}
 
-    int uiX = 24 * 16 + 20;
-    int uiY = 50;
-    SDL_Color white = {255, 255, 255, 255};
-    SDL_Color yellow = {255, 255, 0, 255};
+void Level::removePellet(int cell) {
+    stateHash ^= pelletKey(cell);
+    pickups.removeCell(cell);
+    pelletVersion++;
+}
 
-    if (pacman) {
-        renderText("Lives:", uiX, uiY, white);
-        renderText(std::to_string(pacman->getLives()), uiX + 100, uiY, yellow);
-        renderText("Score:", uiX, uiY + 40, white);
-        renderText(std::to_string(pacman->getScore()), uiX + 100, uiY + 40, yellow);
-    }
+void Level::render() {
+    if (!frameRenderer) return;
+    captureFrame(renderFrame);
+    frameRenderer->render(renderFrame);
 }
 
-void Level::renderMaze() const {
-    SDL_SetRenderDrawColor(renderer, 33, 33, 255, 255);
-    
-    for (int y = 0; y < layout.size(); ++y) {
-        for (int x = 0; x < layout[y].size(); ++x) {
-            if (layout[y][x] == '#') {
-                SDL_Rect wall = {x * 16, y * 16, 16, 16};
-                SDL_RenderFillRect(renderer, &wall);
-            }
-        }
+void Level::invalidateRenderCache() {
+    if (frameRenderer) frameRenderer->invalidate();
+    fruitIcons->invalidateStrip();
+}
+
+void Level::captureFrame(FrameSnapshot& frame) const {
+    captureState(frame.world);
+    frame.pelletVersion = pelletVersion;
+    frame.stateHash = getStateHash();
+    frame.mouthOpen = pacman && pacman->getMouthOpen();
+    frame.hasFruit = pickups.itemCount() > 0;
+    if (frame.hasFruit) {
+        frame.fruitX = static_cast<int16_t>(pickups.itemPixelX(0));
+        frame.fruitY = static_cast<int16_t>(pickups.itemPixelY(0));
+        frame.fruitType = pickups.itemType(0);
     }
+    frame.eatenFruits = eatenFruits;
+    frame.gameOver = gameOverFlag;
 }
 
 bool Level::isWall(int x, int y) const {
@@ -232,9 +455,7 @@ bool Level::isWall(int x, int y) const {
     return true;
 }
 
-void Level::resetPositions() {
-    if (!pacman) return;
-    
+void Level::respawnPacman() {
     for (int y = 0; y < layout.size(); ++y) {
         for (int x = 0; x < layout[y].size(); ++x) {
             if (layout[y][x] == 'P') {
@@ -244,19 +465,23 @@ void Level::resetPositions() {
             }
         }
     }
+}
+
+void Level::resetPositions() {
+    if (!pacman) return;
     
-    for (auto& obj : game_objects) {
-        if (auto ghost = dynamic_cast<Ghost*>(obj.get())) {
-            ghost->setEaten(false);
-            ghost->setIsActive(true);
-            ghost->setFrightened(false);
-            
-            for (int y = 0; y < layout.size(); ++y) {
-                for (int x = 0; x < layout[y].size(); ++x) {
-                    if (layout[y][x] == 'G') {
-                        ghost->setPosition(x, y);
-                        break;
-                    }
+    respawnPacman();
+    
+    for (Ghost* ghost : levelGhosts) {
+        ghost->setEaten(false);
+        ghost->setIsActive(true);
+        ghost->setFrightened(false);
+        
+        for (int y = 0; y < layout.size(); ++y) {
+            for (int x = 0; x < layout[y].size(); ++x) {
+                if (layout[y][x] == 'G') {
+                    ghost->setPosition(x, y);
+                    break;
                 }
             }
         }
@@ -266,28 +491,31 @@ void Level::resetPositions() {
 void Level::restartLevel(bool keepProgress) {
     int savedLives = pacman ? pacman->getLives() : 3;
     int savedScore = pacman ? pacman->getScore() : 0;
-    bool wasPowered = pacman ? pacman->getIsPowered() : false;
 
-    loadFromFile("levels/level1.txt");
+    // Карта уже разобрана при загрузке, файл заново не читается
+    buildFromLayout();
     
     if (keepProgress && pacman) {
         pacman->setLives(savedLives);
         pacman->setScore(savedScore);
-        pacman->activatePower(wasPowered);
     } else {
         eatenFruits.clear();
+        fruitIcons->invalidateStrip();
+        round = 1;
     }
     
     dotsEaten = 0;
     firstFruitSpawned = false;
     secondFruitSpawned = false;
-    currentFruit.reset();
-    
     gameOverFlag = false;
+    roundCleared = false;
 }
 
 void Level::spawnFruit() {
-    FruitType type = (rand() % 2 == 0) ? FruitType::ORANGE : FruitType::APPLE;
+    FruitType type = Fruit::typeForRound(round);
+    if (!rules.fruits.empty()) {
+        type = rules.fruits[std::min<size_t>(firstFruitSpawned ? 1 : 0, rules.fruits.size() - 1)];
+    }
 
     int spawnX = layout[0].size() / 2;
     int spawnY = 20;
@@ -297,47 +525,148 @@ void Level::spawnFruit() {
         spawnY = layout.size() - 2;
     }
     
-    currentFruit = std::make_unique<Fruit>(spawnX, spawnY, type, renderer);
-    fruitTimer = 9.0f;
+    pickups.clearItems();
+    pickups.addFruit(spawnX, spawnY, type, fruitIcons->get(type));
 }
 
 void Level::updateFruit(float deltaTime) {
-    if (currentFruit) {
-        currentFruit->update(deltaTime);
-        fruitTimer -= deltaTime;
-        
-        if (fruitTimer <= 0 || !currentFruit->getIsActive()) {
-            currentFruit.reset();
+    pickups.expireItems(deltaTime);
+
+    for (size_t i = 0; i < pickups.itemCount(); ) {
+        const SDL_Rect box = pacman->getHitbox();
+        const SDL_Rect item = pickups.itemHitbox(i);
+        if (!SDL_HasIntersection(&box, &item)) {
+            ++i;
+            continue;
         }
-        else if (pacman && pacman->checkCollision(*currentFruit)) {
-            pacman->addScore(currentFruit->getPoints());
-            eatenFruits.push_back(currentFruit->getType());
-            
-            // Ограничиваем количество отображаемых фруктов (последние 7)
-            if (eatenFruits.size() > 7) {
-                eatenFruits.erase(eatenFruits.begin());
+        pacman->addScore(pickups.itemPickup(i).points);
+        eatenFruits.push_back(pickups.itemType(i));
+
+        // Ограничиваем количество отображаемых фруктов (последние 7)
+        if (eatenFruits.size() > 7) {
+            eatenFruits.erase(eatenFruits.begin());
+        }
+        fruitIcons->invalidateStrip();
+
+        pickups.removeItem(i);
+    }
+}
+
+void Level::saveState(std::vector<uint8_t>& out) const {
+    // Клетки карты, изменённые с загрузки (открытая дверь загона). Снимки
+    // перемотки пишутся каждые несколько тиков, поэтому без выделения памяти:
+    // сначала число клеток, затем сами клетки
+    size_t changed = 0;
+    for (int y = 0; y < getGridHeight(); ++y) {
+        for (int x = 0; x < static_cast<int>(layout[y].size()); ++x) {
+            if (layout[y][x] != fileLayout[y][x]) changed++;
+        }
+    }
+    putVarint(out, changed);
+    for (int y = 0; y < getGridHeight() && changed > 0; ++y) {
+        for (int x = 0; x < static_cast<int>(layout[y].size()); ++x) {
+            if (layout[y][x] == fileLayout[y][x]) continue;
+            putVarint(out, static_cast<uint32_t>(y * gridWidth + x));
+            out.push_back(static_cast<uint8_t>(layout[y][x]));
+        }
+    }
+
+    // Оставшиеся точки - битами по клеткам, где они были в файле
+    uint8_t bits = 0;
+    int bitCount = 0;
+    for (int y = 0; y < getGridHeight(); ++y) {
+        for (int x = 0; x < static_cast<int>(fileLayout[y].size()); ++x) {
+            const char c = fileLayout[y][x];
+            if (pelletKindFor(c) == PELLET_NONE) continue;
+            if (pickups.kindAt(y * gridWidth + x) != PELLET_NONE) bits |= static_cast<uint8_t>(1u << bitCount);
+            if (++bitCount == 8) {
+                out.push_back(bits);
+                bits = 0;
+                bitCount = 0;
             }
-            
-            currentFruit.reset();
         }
     }
+    if (bitCount > 0) out.push_back(bits);
+
+    putVarint(out, static_cast<uint32_t>(dotsEaten));
+    putVarint(out, static_cast<uint32_t>(round));
+    const bool hasFruit = pickups.itemCount() > 0;
+    out.push_back(static_cast<uint8_t>((firstFruitSpawned ? 1 : 0) | (secondFruitSpawned ? 2 : 0) |
+                                       (gameOverFlag ? 4 : 0) | (hasFruit ? 8 : 0)));
+    // Время фрукта; его же хранит блок фрукта ниже
+    putFloat(out, hasFruit ? pickups.itemSeconds(0) : 0.0f);
+    putVarint(out, eatenFruits.size());
+    for (FruitType type : eatenFruits) out.push_back(static_cast<uint8_t>(type));
+    if (hasFruit) {
+        out.push_back(static_cast<uint8_t>(pickups.itemType(0)));
+        pickups.saveFruit(0, out);
+    }
+
+    pacman->saveState(out);
+    ghostSystem.saveState(out);
 }
 
-void Level::renderEatenFruits() const {
-    if (eatenFruits.empty()) return;
-    
-    int startX = 100;
-    int y = layout.size() * 16 + 10;
-    int spacing = 20;
-    
-    for (size_t i = 0; i < eatenFruits.size(); ++i) {
-        const std::string& texturePath = Fruit::fruitTextures.at(eatenFruits[i]);
-        SDL_Texture* texture = IMG_LoadTexture(renderer, texturePath.c_str());
-        
-        if (texture) {
-            SDL_Rect dst = {startX + static_cast<int>(i) * spacing, y, 16, 16};
-            SDL_RenderCopy(renderer, texture, nullptr, &dst);
-            SDL_DestroyTexture(texture);
+bool Level::restoreState(const uint8_t* data, size_t size) {
+    if (fileLayout.empty() || !pacman) return false;
+    buildFromLayout(true);
+    ByteReader in{data, size, 0};
+
+    size_t changedCount;
+    if (!in.varint(changedCount)) return false;
+    for (size_t i = 0; i < changedCount; ++i) {
+        uint32_t cell;
+        uint8_t c;
+        if (!in.varint(cell) || !in.byte(c)) return false;
+        const int y = static_cast<int>(cell) / gridWidth, x = static_cast<int>(cell) % gridWidth;
+        if (y >= getGridHeight() || x >= static_cast<int>(layout[y].size())) return false;
+        layout[y][x] = static_cast<char>(c);
+    }
+
+    uint8_t bits = 0;
+    int bitCount = 8;
+    for (int y = 0; y < getGridHeight(); ++y) {
+        for (int x = 0; x < static_cast<int>(fileLayout[y].size()); ++x) {
+            const char c = fileLayout[y][x];
+            if (pelletKindFor(c) == PELLET_NONE) continue;
+            if (bitCount == 8) {
+                if (!in.byte(bits)) return false;
+                bitCount = 0;
+            }
+            if (!((bits >> bitCount++) & 1)) removePellet(y * gridWidth + x);
         }
     }
-}
\ No newline at end of file
+
+    uint8_t flags, type;
+    size_t eatenCount;
+    float fruitSeconds;
+    if (!in.varint(dotsEaten) || !in.varint(round) || !in.byte(flags) || !in.floatValue(fruitSeconds) ||
+        !in.varint(eatenCount) || eatenCount > 7) {
+        return false;
+    }
+    firstFruitSpawned = (flags & 1) != 0;
+    secondFruitSpawned = (flags & 2) != 0;
+    gameOverFlag = (flags & 4) != 0;
+    roundCleared = false;
+    eatenFruits.clear();
+    for (size_t i = 0; i < eatenCount; ++i) {
+        if (!in.byte(type) || type >= kFruitTypeCount) return false;
+        eatenFruits.push_back(static_cast<FruitType>(type));
+    }
+    fruitIcons->invalidateStrip();
+    if (flags & 8) {
+        if (!in.byte(type) || type >= kFruitTypeCount) return false;
+        const FruitType fruitType = static_cast<FruitType>(type);
+        if (!pickups.restoreFruit(in, fruitType, fruitIcons->get(fruitType))) return false;
+    }
+
+    if (!pacman->restoreState(in) || !ghostSystem.restoreState(in)) return false;
+    for (Ghost* ghost : levelGhosts) {
+        ghost->syncFromSystem();
+    }
+    rehash();
+    return in.pos == in.size;
+}
+
+LevelAllocationStats Level::getAllocationStats() const {
+    return {ghosts.getStats(), ghostSystem.getStats(), pickups.getCellStats(), pickups.getItemStats()};
+}
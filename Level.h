@@ -2,41 +2,189 @@
 #include <vector>
 #include <memory>
 #include "Characters.h"
-#include <SDL2/SDL_ttf.h>
+#include "FruitIcons.h"
+#include "GhostSystem.h"
+#include "ObjectPool.h"
+#include "FrameSnapshot.h"
+#include "PickupSystem.h"
 
+class JobSystem;
+class AssetManager;
+class StateBroadcaster;
+class FrameRenderer;
+struct StreamState;
+
+// Счётчики пулов и архетипов уровня (см. ObjectPool, Archetype)
+struct LevelAllocationStats {
+    PoolStats ghosts;
+    PoolStats ghostEntities;
+    PoolStats pellets;
+    PoolStats fruits;
+};
+
+// Фазы тика в порядке выполнения. Системы - методы Level в таблице
+// Level::kTickSystems, упорядоченной по фазам: новый вид сущностей
+// добавляет строку в свою фазу, а не цикл в advance
+enum class TickPhase { PLAYER, PICKUP, AI, MOVEMENT, COLLISION, RULES };
+
+// Правила уровня кампании (см. Campaign); по умолчанию - как в оригинале
+struct LevelRules {
+    int speedPercent = 100;          // множитель скоростей Пакмана и призраков
+    float frightenedSeconds = 5.0f;  // испуг призраков от энерджайзера
+    // Фрукты первого и второго появления за раунд; пусто - по номеру раунда
+    std::vector<FruitType> fruits;
+};
+
+// Уровень без рендерера (renderer == nullptr) работает без графики:
+// так его используют среда обучения (Env) и безголовые режимы
 class Level {
 private:
     std::vector<std::string> layout;
+    // Карта в том виде, в каком загружена: из неё строятся раунды, с ней
+    // сравнивается текущая карта в сохранённом состоянии
+    std::vector<std::string> fileLayout;
+    // Разбор fileLayout, из которого строится каждый раунд: перезапуск
+    // раунда и сброс среды обучения (Env) карту заново не сканируют
+    std::vector<uint8_t> startPellets;
+    uint64_t startPelletHash = 0;
+    int startPacmanX = -1;
+    int startPacmanY = -1;
+    std::vector<std::pair<int, int>> ghostSpawns;
+    std::string levelPath;
+    std::string levelText;
     std::unique_ptr<Pacman> pacman;
-    std::vector<std::unique_ptr<GameObject>> game_objects;
+    // Сущности живут в архетипах GhostSystem и PickupSystem и переиспользуют
+    // память между раундами. Объекты Ghost - фасады над GhostSystem из пула
+    ObjectPool<Ghost, 8> ghosts;
+    GhostSystem ghostSystem;
+    PickupSystem pickups;
+    JobSystem* jobs = nullptr;
+    StateBroadcaster* stateStream = nullptr;
+    int gridWidth = 0;
+    std::vector<Ghost*> levelGhosts;
     SDL_Renderer* renderer;
-    TTF_Font* font;
-    void renderMaze() const;
+    AssetManager& assets;
+    std::unique_ptr<FrameRenderer> frameRenderer;
+    FrameSnapshot renderFrame;
+    // Растёт при каждом изменении точек (FrameSnapshot::pelletVersion)
+    uint32_t pelletVersion = 0;
+    // Хэш Зобриста точек, изменённых клеток карты и тайла Пакмана; часть
+    // призраков ведёт GhostSystem. Полностью считается только при постройке
+    // и восстановлении уровня, дальше обновляется по изменениям
+    uint64_t stateHash = 0;
+    int hashedPacmanX = 0;
+    int hashedPacmanY = 0;
     bool isWall(int x, int y) const;
+    void respawnPacman();
     void resetPositions();
     bool gameOverFlag = false;
+    bool holdClearedRound = false;
+    bool roundCleared = false;
 
+    LevelRules rules;
     int dotsEaten = 0;
+    int round = 1;
     bool firstFruitSpawned = false;
     bool secondFruitSpawned = false;
-    std::unique_ptr<Fruit> currentFruit;
     std::vector<FruitType> eatenFruits;
-    float fruitTimer = 0.0f;
+    std::unique_ptr<FruitIcons> fruitIcons;
+
+    struct TickSystem {
+        TickPhase phase;
+        void (Level::*run)(float deltaTime);
+    };
+    static const TickSystem kTickSystems[];
     
+    void clearEntities();
+    void eatPellet(int cell);
+    void removePellet(int cell);
+    // После каждого изменения fileLayout
+    void parseLayout();
+    // keepPacman - не пересоздавать Пакмана, его состояние восстановят следом
+    void buildFromLayout(bool keepPacman = false);
+    void applyRules();
     void spawnFruit();
+    // Системы тика (kTickSystems)
+    void movePacman(float deltaTime);
+    void eatPellets(float deltaTime);
     void updateFruit(float deltaTime);
-    void renderEatenFruits() const;
+    void thinkGhosts(float deltaTime);
+    void moveGhosts(float deltaTime);
+    void resolveGhostCollisions(float deltaTime);
+    void checkRoundEnd(float deltaTime);
+    void finishTick(float deltaTime);
+    void advance(float deltaTime);
+    uint64_t pelletKey(int cell) const;
+    uint64_t cellKey(int x, int y) const;
+    uint64_t computeOwnHash() const;
+    void rehash();
+    void updatePacmanHash();
 
 public:
-    Level(SDL_Renderer* renderer);
+    Level(SDL_Renderer* renderer, AssetManager& assets);
     ~Level();
     bool loadFromFile(const std::string& path);
+    // Уровень из текста карты; path - имя для сообщений и повторов
+    void loadFromText(const std::string& path, const std::string& text);
+    // Горячая перезагрузка изменённого файла карты. Применяются только
+    // клетки, отличающиеся от прежнего файла: стены, точки, точка появления
+    // Пакмана. Остальные точки, Пакман и призраки остаются как были, кроме
+    // тех, кто оказался в стене. Если изменились размеры карты или клетки
+    // призраков, карта строится заново новым раундом со счётом и жизнями.
+    // Возвращает число изменённых клеток, -1 - карта построена заново
+    int reloadFromText(const std::string& text);
+    const std::string& getLevelPath() const { return levelPath; }
+    const std::string& getLevelText() const { return levelText; }
+    // Применяется сразу и сохраняется при перезапусках раунда
+    void setRules(const LevelRules& newRules);
+    const LevelRules& getRules() const { return rules; }
+    // Следующий уровень кампании: жизни, счёт, раунд и съеденные фрукты
+    // переходят из previous
+    void continueFrom(const Level& previous);
+    // Раунд, очищенный от точек, не начинается заново на этой же карте:
+    // уровень только отмечает его (isRoundCleared), и владелец подставляет
+    // следующий уровень кампании без лишней перестройки этого
+    void setHoldClearedRound(bool hold) { holdClearedRound = hold; }
+    bool isRoundCleared() const { return roundCleared; }
     void update(float deltaTime);
+    // Один тик kTickSeconds без трансляции: для прогона многих тиков подряд
+    // (ускорение, обучение); состояние зрителям отправляет publishState()
+    void tick() { advance(kTickSeconds); }
+    void publishState();
     
+    // Отрисовка через снимок (captureFrame + FrameRenderer) в том же потоке
     void render();
+    // Кэшированные текстуры перерисуются при следующем render()
+    void invalidateRenderCache();
+    // Снимок для отрисовки в другом потоке (см. Simulation)
+    void captureFrame(FrameSnapshot& frame) const;
     Pacman* getPacman() { return pacman.get(); }
+    const Pacman* getPacman() const { return pacman.get(); }
     const std::vector<std::string>& getMap() const { return layout; }
-    void renderText(const std::string& text, int x, int y, SDL_Color color);
     bool isGameOver() const { return gameOverFlag; }
+    int getRound() const { return round; }
     void restartLevel(bool keepProgress);
+    LevelAllocationStats getAllocationStats() const;
+    void setJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
+    // После каждого тика состояние уходит в поток для зрителей
+    void setStateStream(StateBroadcaster* stream) { stateStream = stream; }
+    void captureState(StreamState& state) const;
+    // Полное состояние симуляции (ключевой кадр повтора, перемотка).
+    // Восстанавливается поверх той же загруженной карты; false - данные повреждены
+    void saveState(std::vector<uint8_t>& out) const;
+    bool restoreState(const uint8_t* data, size_t size);
+    // Хэш Зобриста состояния (Zobrist.h): точки, открытые клетки карты, тайлы
+    // Пакмана и призраков, режимы призраков. Обновляется по ходу тика, а не
+    // пересчётом карты; одинаков на любой машине при одинаковой игре
+    uint64_t getStateHash() const { return stateHash ^ ghostSystem.getHash(); }
+    // Тот же хэш, посчитанный заново по всему уровню - для проверки
+    uint64_t computeStateHash() const { return computeOwnHash() ^ ghostSystem.computeHash(); }
+    // Зерно генераторов призраков, применяется при следующей загрузке
+    void setSeed(uint32_t seed) { ghostSystem.setSeed(seed); }
+
+    const GhostSystem& getGhostSystem() const { return ghostSystem; }
+    const std::vector<uint8_t>& getPelletGrid() const { return pickups.getKindGrid(); }
+    int getGridWidth() const { return gridWidth; }
+    int getGridHeight() const { return static_cast<int>(layout.size()); }
+    int getPelletsLeft() const { return static_cast<int>(pickups.cellCount()); }
 };
\ No newline at end of file
@@ -1,15 +1,117 @@
 #include "MainMenu.h"
+#include <iostream>
 
 MainMenu::MainMenu(SDL_Renderer* renderer) : BaseMenu(renderer) {
     bg_color = {30, 30, 50, 255};
 }
 
-std::string MainMenu::handleClick(int x, int y) {
+bool MainMenu::loadConfig(const std::string& path) {
+    configPath = path;
+    std::error_code ec;
+    configTime = std::filesystem::last_write_time(path, ec);
+
+    MenuGraph graph;
+    std::string error;
+    if (!loadMenuGraph(path, graph, error)) {
+        std::cerr << "Menu config error: " << error << std::endl;
+        if (screens.empty()) loadDefaults();
+        return false;
+    }
+
+    compile(graph);
+    return true;
+}
+
+bool MainMenu::reloadIfChanged() {
+    if (configPath.empty()) return false;
+
+    Uint32 now = SDL_GetTicks();
+    if (now - lastCheckTime < kReloadCheckInterval) return false;
+    lastCheckTime = now;
+
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(configPath, ec);
+    if (ec || time == configTime) return false;
+
+    std::cout << "Reloading " << configPath << std::endl;
+    return loadConfig(configPath);
+}
+
+void MainMenu::compile(const MenuGraph& graph) {
+    std::string activeName = (currentScreen >= 0) ? screens[currentScreen].name : "";
+
+    buttons.clear();
+    releaseLabels();
+    screens.clear();
+    history.clear();
+
+    for (const auto& def : graph.screens) {
+        CompiledScreen screen{def.name, def.background, {}};
+        for (const auto& buttonDef : def.buttons) {
+            Button button(buttonDef);
+            button.label = prerenderLabel(button.text);
+            screen.buttons.push_back(button);
+        }
+        screens.push_back(screen);
+    }
+    rootScreen = graph.rootScreen;
+
+    // После перезагрузки остаёмся на том же экране, если он ещё есть
+    int active = graph.findScreen(activeName);
+    showScreen(active >= 0 ? active : rootScreen);
+}
+
+void MainMenu::loadDefaults() {
+    MenuGraph graph;
+    MenuScreenDef screen;
+    screen.name = "main_menu";
+
+    MenuButtonDef start;
+    start.rect = {300, 100, 200, 50};
+    start.text = "Start Game";
+    start.action = MenuAction::START;
+    start.color = {100, 200, 100, 255};
+    screen.buttons.push_back(start);
+
+    MenuButtonDef exit;
+    exit.rect = {300, 200, 200, 50};
+    exit.text = "Exit";
+    exit.action = MenuAction::EXIT;
+    exit.color = {200, 50, 50, 255};
+    screen.buttons.push_back(exit);
+
+    graph.screens.push_back(screen);
+    compile(graph);
+}
+
+void MainMenu::showScreen(int index) {
+    if (index < 0 || index >= static_cast<int>(screens.size())) return;
+    currentScreen = index;
+    bg_color = screens[index].background;
+    buttons = screens[index].buttons;
+}
+
+const Button* MainMenu::handleClick(int x, int y) {
     SDL_Point point = {x, y};
     for (const auto& button : getButtons()) {
-        if (SDL_PointInRect(&point, &button.rect)) {
-            return button.action;
+        if (!SDL_PointInRect(&point, &button.rect)) continue;
+
+        switch (button.action) {
+            case MenuAction::OPEN:
+                history.push_back(currentScreen);
+                showScreen(button.targetScreen);
+                return nullptr;
+
+            case MenuAction::BACK:
+                if (!history.empty()) {
+                    showScreen(history.back());
+                    history.pop_back();
+                }
+                return nullptr;
+
+            default:
+                return &button;
         }
     }
-    return "";
-}
\ No newline at end of file
+    return nullptr;
+}
@@ -1,8 +1,42 @@
 #pragma once
 #include "BaseMenu.h"
+#include "MenuConfig.h"
+#include <filesystem>
+#include <string>
+#include <vector>
 
+// Меню, собранное из menu_config.json. Конфигурация разбирается один раз,
+// надписи кнопок всех экранов отрисовываются заранее. Файл перечитывается,
+// если он изменился на диске.
 class MainMenu : public BaseMenu {
 public:
+    static constexpr Uint32 kReloadCheckInterval = 500; // мс
+
     MainMenu(SDL_Renderer* renderer);
-    std::string handleClick(int x, int y);
-};
\ No newline at end of file
+    bool loadConfig(const std::string& path);
+    bool reloadIfChanged();
+
+    // Переходы между экранами обрабатываются внутри меню, наружу
+    // возвращаются только кнопки с действиями для приложения
+    const Button* handleClick(int x, int y);
+
+private:
+    struct CompiledScreen {
+        std::string name;
+        SDL_Color background;
+        std::vector<Button> buttons;
+    };
+
+    std::vector<CompiledScreen> screens;
+    std::vector<int> history;
+    int currentScreen = -1;
+    int rootScreen = 0;
+
+    std::string configPath;
+    std::filesystem::file_time_type configTime;
+    Uint32 lastCheckTime = 0;
+
+    void compile(const MenuGraph& graph);
+    void loadDefaults();
+    void showScreen(int index);
+};
@@ -0,0 +1,102 @@
+#include "MenuConfig.h"
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+    SDL_Rect parseRect(const json& value) {
+        if (!value.is_array() || value.size() != 4) {
+            throw std::runtime_error("rect must be [x, y, w, h]");
+        }
+        return {value[0].get<int>(), value[1].get<int>(), value[2].get<int>(), value[3].get<int>()};
+    }
+
+    SDL_Color parseColor(const json& value) {
+        if (!value.is_array() || value.size() < 3) {
+            throw std::runtime_error("color must be [r, g, b] or [r, g, b, a]");
+        }
+        Uint8 alpha = value.size() > 3 ? value[3].get<Uint8>() : 255;
+        return {value[0].get<Uint8>(), value[1].get<Uint8>(), value[2].get<Uint8>(), alpha};
+    }
+}
+
+MenuAction parseMenuAction(const std::string& name) {
+    if (name == "open") return MenuAction::OPEN;
+    if (name == "back") return MenuAction::BACK;
+    if (name == "start") return MenuAction::START;
+    if (name == "exit") return MenuAction::EXIT;
+    if (name == "dialog") return MenuAction::DIALOG;
+    return MenuAction::NONE;
+}
+
+int MenuGraph::findScreen(const std::string& name) const {
+    for (size_t i = 0; i < screens.size(); ++i) {
+        if (screens[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool loadMenuGraph(const std::string& path, MenuGraph& graph, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "failed to open " + path;
+        return false;
+    }
+
+    MenuGraph result;
+    try {
+        json root = json::parse(file);
+        if (!root.is_object()) {
+            error = "menu config root must be an object";
+            return false;
+        }
+
+        for (auto it = root.begin(); it != root.end(); ++it) {
+            MenuScreenDef screen;
+            screen.name = it.key();
+            if (it->contains("background")) {
+                screen.background = parseColor(it->at("background"));
+            }
+
+            for (const auto& item : it->value("buttons", json::array())) {
+                MenuButtonDef button;
+                button.text = item.value("text", "");
+                button.action = parseMenuAction(item.value("action", ""));
+                button.target = item.value("target", "");
+                button.rect = parseRect(item.at("rect"));
+                button.color = parseColor(item.value("color", json::array({0, 0, 0})));
+                if (button.action == MenuAction::NONE) {
+                    error = "unknown action in screen " + screen.name + ": " + item.value("action", "");
+                    return false;
+                }
+                screen.buttons.push_back(button);
+            }
+            result.screens.push_back(screen);
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+
+    // Разрешаем ссылки на экраны в индексы
+    for (auto& screen : result.screens) {
+        for (auto& button : screen.buttons) {
+            if (button.action != MenuAction::OPEN) continue;
+            button.targetScreen = result.findScreen(button.target);
+            if (button.targetScreen < 0) {
+                error = "unknown screen: " + button.target;
+                return false;
+            }
+        }
+    }
+
+    result.rootScreen = result.findScreen("main_menu");
+    if (result.rootScreen < 0) {
+        error = "menu config has no main_menu screen";
+        return false;
+    }
+
+    graph = std::move(result);
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+// Действия кнопок меню. Строки из menu_config.json переводятся в эти
+// значения один раз при загрузке.
+enum class MenuAction { NONE, OPEN, BACK, START, EXIT, DIALOG };
+
+MenuAction parseMenuAction(const std::string& name);
+
+struct MenuButtonDef {
+    SDL_Rect rect = {0, 0, 0, 0};
+    std::string text;
+    MenuAction action = MenuAction::NONE;
+    std::string target;
+    int targetScreen = -1; // индекс экрана для OPEN, -1 если цель не экран
+    SDL_Color color = {0, 0, 0, 255};
+};
+
+struct MenuScreenDef {
+    std::string name;
+    SDL_Color background = {30, 30, 50, 255};
+    std::vector<MenuButtonDef> buttons;
+};
+
+// Граф меню: экраны и переходы между ними, ссылки разрешены в индексы
+struct MenuGraph {
+    std::vector<MenuScreenDef> screens;
+    int rootScreen = 0;
+
+    int findScreen(const std::string& name) const;
+};
+
+bool loadMenuGraph(const std::string& path, MenuGraph& graph, std::string& error);
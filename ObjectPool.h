@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Счётчики пула: сколько раз выделяли память под блоки и сколько объектов
+// было создано/уничтожено. Используются для проверки, что в установившемся
+// режиме игры нет выделений памяти в куче.
+struct PoolStats {
+    size_t chunkAllocations = 0;
+    size_t constructed = 0;
+    size_t destroyed = 0;
+    size_t live = 0;
+    size_t capacity = 0;
+};
+
+// Типизированный пул объектов. Память выделяется блоками по ChunkSize слотов
+// и не возвращается в кучу до уничтожения пула: clear() разом уничтожает все
+// живые объекты и переиспользует те же слоты при следующей загрузке уровня.
+template <typename T, size_t ChunkSize = 64>
+class ObjectPool {
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        Slot* next = nullptr;
+        bool alive = false;
+
+        T* object() { return reinterpret_cast<T*>(storage); }
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* freeList = nullptr;
+    PoolStats stats;
+
+    void grow() {
+        chunks.emplace_back(new Slot[ChunkSize]);
+        Slot* chunk = chunks.back().get();
+        for (size_t i = 0; i < ChunkSize; ++i) {
+            chunk[i].next = (i + 1 < ChunkSize) ? &chunk[i + 1] : freeList;
+        }
+        freeList = chunk;
+        stats.chunkAllocations++;
+        stats.capacity += ChunkSize;
+    }
+
+    static Slot* slotOf(T* object) {
+        // storage - первый член Slot, поэтому адрес объекта совпадает с адресом слота
+        return reinterpret_cast<Slot*>(object);
+    }
+
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { clear(); }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Заранее выделяет память хотя бы под count объектов
+    void reserve(size_t count) {
+        while (stats.capacity < count) grow();
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (!freeList) grow();
+
+        Slot* slot = freeList;
+        T* object = new (slot->storage) T(std::forward<Args>(args)...);
+        freeList = slot->next;
+        slot->alive = true;
+
+        stats.constructed++;
+        stats.live++;
+        return object;
+    }
+
+    void destroy(T* object) {
+        if (!object) return;
+
+        Slot* slot = slotOf(object);
+        object->~T();
+        slot->alive = false;
+        slot->next = freeList;
+        freeList = slot;
+
+        stats.destroyed++;
+        stats.live--;
+    }
+
+    // Уничтожает все живые объекты за один проход, память остаётся в пуле
+    void clear() {
+        freeList = nullptr;
+        for (auto chunk = chunks.rbegin(); chunk != chunks.rend(); ++chunk) {
+            for (size_t i = ChunkSize; i-- > 0; ) {
+                Slot& slot = (*chunk)[i];
+                if (slot.alive) {
+                    slot.object()->~T();
+                    slot.alive = false;
+                    stats.destroyed++;
+                }
+                slot.next = freeList;
+                freeList = &slot;
+            }
+        }
+        stats.live = 0;
+    }
+
+    size_t size() const { return stats.live; }
+    const PoolStats& getStats() const { return stats; }
+};
@@ -0,0 +1,127 @@
+#include "PelletLayer.h"
+#include "AssetManager.h"
+#include "StateStream.h"
+#include <iostream>
+
+PelletLayer::PelletLayer(SDL_Renderer* renderer, AssetManager& assets) : renderer(renderer) {
+    if (!renderer) return;
+    for (int kind = PELLET_NONE + 1; kind < PELLET_KIND_COUNT; ++kind) {
+        textures[kind] = assets.getTexture(kPickupRules[kind].sprite, renderer);
+    }
+}
+
+PelletLayer::~PelletLayer() {
+    if (layer) SDL_DestroyTexture(layer);
+}
+
+bool PelletLayer::ensureLayer(int width, int height) {
+    if (layerFailed) return false;
+    if (layer && layerWidth == width && layerHeight == height) return true;
+    if (layer) SDL_DestroyTexture(layer);
+
+    layer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                              width * kTileSize, height * kTileSize);
+    layerWidth = width;
+    layerHeight = height;
+    dirty = true;
+    if (!layer) {
+        layerFailed = true;
+        std::cerr << "Pellet layer texture unavailable, drawing pellets one by one: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(layer, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void PelletLayer::drawCell(const std::vector<uint8_t>& cells, int width, int cell) {
+    const PelletKind kind = pelletKindForCell(cells[cell]);
+    if (kind == PELLET_NONE) return;
+    if (kPickupRules[kind].blinks) {
+        blinkingCells.push_back(cell);
+        return;
+    }
+    SDL_Rect dst = {cell % width * kTileSize, cell / width * kTileSize, kTileSize, kTileSize};
+    SDL_RenderCopy(renderer, textures[kind], nullptr, &dst);
+}
+
+void PelletLayer::rebuild(const std::vector<uint8_t>& cells, int width, int height) {
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, layer);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    blinkingCells.clear();
+    for (int cell = 0; cell < width * height; ++cell) {
+        drawCell(cells, width, cell);
+    }
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    drawn = cells;
+    dirty = false;
+}
+
+void PelletLayer::renderBlinking(const std::vector<uint8_t>& cells, int width) {
+    if ((SDL_GetTicks() / kBlinkMs) % 2 != 0) return;
+    for (int cell : blinkingCells) {
+        // Подобранная клетка остаётся в списке до перестройки слоя
+        const PelletKind kind = pelletKindForCell(cells[cell]);
+        if (kind == PELLET_NONE) continue;
+        SDL_Rect dst = {cell % width * kTileSize, cell / width * kTileSize, kTileSize, kTileSize};
+        SDL_RenderCopy(renderer, textures[kind], nullptr, &dst);
+    }
+}
+
+void PelletLayer::render(const std::vector<uint8_t>& cells, int width, int height, uint32_t version) {
+    if (!renderer || width <= 0 || height <= 0) return;
+
+    if (!ensureLayer(width, height)) {
+        blinkingCells.clear();
+        for (int cell = 0; cell < width * height; ++cell) {
+            drawCell(cells, width, cell);
+        }
+        renderBlinking(cells, width);
+        return;
+    }
+
+    if (dirty || version != drawnVersion) {
+        sync(cells, width, height);
+        drawnVersion = version;
+    }
+
+    SDL_Rect dst = {0, 0, layerWidth * kTileSize, layerHeight * kTileSize};
+    SDL_RenderCopy(renderer, layer, nullptr, &dst);
+    renderBlinking(cells, width);
+}
+
+void PelletLayer::sync(const std::vector<uint8_t>& cells, int width, int height) {
+    // Между кадрами точки только исчезают; появившаяся точка - новый раунд
+    erased.clear();
+    for (size_t cell = 0; cell < cells.size() && !dirty; ++cell) {
+        if (cells[cell] == drawn[cell]) continue;
+        if (cells[cell] != STREAM_EMPTY) {
+            dirty = true;
+        } else {
+            const PelletKind kind = pelletKindForCell(drawn[cell]);
+            if (kind != PELLET_NONE && !kPickupRules[kind].blinks) {
+                const int x = static_cast<int>(cell) % width, y = static_cast<int>(cell) / width;
+                erased.push_back({x * kTileSize, y * kTileSize, kTileSize, kTileSize});
+            }
+            drawn[cell] = STREAM_EMPTY;
+        }
+    }
+
+    if (dirty) {
+        rebuild(cells, width, height);
+    } else if (!erased.empty()) {
+        // Стирание - замена пикселей клетки прозрачными, без смешивания
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        SDL_BlendMode previousBlend;
+        SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+        SDL_SetRenderTarget(renderer, layer);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderFillRects(renderer, erased.data(), static_cast<int>(erased.size()));
+        SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+        SDL_SetRenderTarget(renderer, previousTarget);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+#include "Pickups.h"
+
+class AssetManager;
+
+// Точки лабиринта одним слоем. Все точки рисуются в текстуру-цель один раз
+// за раунд, съеденная стирается прямоугольником своей клетки, и кадр стоит
+// одного SDL_RenderCopy вместо копии на каждую точку. Виды и картинки
+// берутся из kPickupRules; мигающие (энерджайзеры) в слой не входят и
+// рисуются поверх, их всего несколько.
+class PelletLayer {
+public:
+    static const int kTileSize = 16;
+    // Полупериод мигания
+    static const Uint32 kBlinkMs = 200;
+
+    PelletLayer(SDL_Renderer* renderer, AssetManager& assets);
+    ~PelletLayer();
+    PelletLayer(const PelletLayer&) = delete;
+    PelletLayer& operator=(const PelletLayer&) = delete;
+
+    // Сверяет слой с клетками уровня (StreamCell): съеденные точки
+    // стираются, а если точки появились (новый раунд) - слой
+    // перерисовывается целиком. При той же version сверка пропускается
+    void render(const std::vector<uint8_t>& cells, int width, int height, uint32_t version);
+    // Содержимое текстур-целей теряется при SDL_RENDER_TARGETS_RESET
+    void invalidate() { dirty = true; }
+
+private:
+    SDL_Renderer* renderer;
+    SDL_Texture* textures[PELLET_KIND_COUNT] = {};
+    SDL_Texture* layer = nullptr;
+    bool layerFailed = false; // текстуры-цели недоступны, рисуем по точке
+    int layerWidth = 0;
+    int layerHeight = 0;
+    bool dirty = true;
+    uint32_t drawnVersion = 0;
+    // Что сейчас нарисовано в слое, по клеткам
+    std::vector<uint8_t> drawn;
+    std::vector<int> blinkingCells;
+    std::vector<SDL_Rect> erased;
+
+    bool ensureLayer(int width, int height);
+    void sync(const std::vector<uint8_t>& cells, int width, int height);
+    void rebuild(const std::vector<uint8_t>& cells, int width, int height);
+    // Клетку слоя рисует, мигающую откладывает в blinkingCells
+    void drawCell(const std::vector<uint8_t>& cells, int width, int cell);
+    void renderBlinking(const std::vector<uint8_t>& cells, int width);
+};
@@ -0,0 +1,71 @@
+#include "PickupSystem.h"
+
+void PickupSystem::reset(int gridWidth, const std::vector<uint8_t>& startKinds) {
+    width = gridWidth;
+    kinds = startKinds;
+    cellEntity.assign(kinds.size(), 0);
+    cells.clear();
+    items.clear();
+
+    for (size_t cell = 0; cell < kinds.size(); ++cell) {
+        const PelletKind kind = static_cast<PelletKind>(kinds[cell]);
+        if (kind == PELLET_NONE) continue;
+        const int x = static_cast<int>(cell) % width, y = static_cast<int>(cell) / width;
+        cellEntity[cell] = static_cast<uint32_t>(cells.add(Tile{x, y}, Pickup{kPickupRules[kind].points, kind}));
+    }
+}
+
+void PickupSystem::addCell(int cell, PelletKind kind) {
+    kinds[cell] = kind;
+    cellEntity[cell] = static_cast<uint32_t>(
+        cells.add(Tile{cell % width, cell / width}, Pickup{kPickupRules[kind].points, kind}));
+}
+
+void PickupSystem::removeCell(int cell) {
+    const size_t entity = cellEntity[cell];
+    // На место удалённой переезжает последняя сущность: её клетка
+    // запоминает новый номер
+    if (cells.remove(entity) != entity) {
+        const Tile& moved = cells.get<Tile>(entity);
+        cellEntity[moved.y * width + moved.x] = static_cast<uint32_t>(entity);
+    }
+    kinds[cell] = PELLET_NONE;
+}
+
+Pellet PickupSystem::pelletAt(int cell) const {
+    return Pellet(cell % width, cell / width, kindAt(cell));
+}
+
+size_t PickupSystem::addFruit(int tileX, int tileY, FruitType type, SDL_Texture* icon) {
+    return items.add(Tile{tileX, tileY}, Position{tileCenterFixed(tileX), tileCenterFixed(tileY)}, Sprite{icon},
+                     Pickup{Fruit::pointsFor(type), PELLET_NONE}, Lifetime{kFruitSeconds}, FruitInfo{type});
+}
+
+Fruit PickupSystem::fruitAt(size_t i) const {
+    const Tile& tile = items.get<Tile>(i);
+    return Fruit(tile.x, tile.y, items.get<FruitInfo>(i).type, items.get<Sprite>(i).texture);
+}
+
+void PickupSystem::expireItems(float deltaTime) {
+    // С конца: удаление переносит на место i уже обработанную сущность
+    for (size_t i = items.size(); i-- > 0; ) {
+        float& seconds = items.get<Lifetime>(i).seconds;
+        seconds -= deltaTime;
+        if (seconds <= 0) items.remove(i);
+    }
+}
+
+void PickupSystem::saveFruit(size_t i, std::vector<uint8_t>& out) const {
+    fruitAt(i).saveMotion(out);
+    putFloat(out, items.get<Lifetime>(i).seconds);
+}
+
+bool PickupSystem::restoreFruit(ByteReader& in, FruitType type, SDL_Texture* icon) {
+    Fruit fruit(0, 0, type, icon);
+    float seconds;
+    if (!fruit.restoreMotion(in) || !in.floatValue(seconds)) return false;
+    // Фрукт не двигается: позиция - центр его клетки
+    const size_t i = addFruit(fruit.getTileX(), fruit.getTileY(), type, icon);
+    items.get<Lifetime>(i).seconds = seconds;
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Archetype.h"
+#include "Characters.h"
+#include "Components.h"
+#include "Pickups.h"
+
+// Всё, что Пакман подбирает, - сущности двух архетипов с компонентом Pickup.
+// Клетки (точки, энерджайзеры) неподвижны и их сотни: сетка уровня хранит
+// вид клетки и номер её сущности, поэтому поедание проверяет только клетки
+// под Пакманом, а зрители и автопилот читают вид клеток одним массивом.
+// Предметы (фрукт) стоят в клетке ограниченное время: позиция, спрайт и
+// Lifetime. Новый подбираемый вид - строка kPickupRules или предмет со
+// своими компонентами; правила игры (счёт, появление фрукта) в Level
+class PickupSystem {
+public:
+    // Секунды, которые фрукт стоит на уровне
+    static constexpr float kFruitSeconds = 9.0f;
+
+    // Сетка шириной width; kinds - PelletKind каждой клетки. Прежние клетки и
+    // предметы удаляются, память остаётся для следующего раунда
+    void reset(int width, const std::vector<uint8_t>& kinds);
+
+    PelletKind kindAt(int cell) const { return static_cast<PelletKind>(kinds[cell]); }
+    // Вид каждой клетки сетки (PelletKind), PELLET_NONE - пусто
+    const std::vector<uint8_t>& getKindGrid() const { return kinds; }
+    size_t cellCount() const { return cells.size(); }
+    // Клетка должна быть пустой
+    void addCell(int cell, PelletKind kind);
+    void removeCell(int cell);
+    const Pickup& cellPickup(int cell) const { return cells.get<Pickup>(cellEntity[cell]); }
+    Pellet pelletAt(int cell) const;
+
+    size_t addFruit(int tileX, int tileY, FruitType type, SDL_Texture* icon);
+    size_t itemCount() const { return items.size(); }
+    void removeItem(size_t i) { items.remove(i); }
+    void clearItems() { items.clear(); }
+    Fruit fruitAt(size_t i) const;
+    const Pickup& itemPickup(size_t i) const { return items.get<Pickup>(i); }
+    FruitType itemType(size_t i) const { return items.get<FruitInfo>(i).type; }
+    int itemPixelX(size_t i) const { return fixedFloor(items.get<Position>(i).x); }
+    int itemPixelY(size_t i) const { return fixedFloor(items.get<Position>(i).y); }
+    float itemSeconds(size_t i) const { return items.get<Lifetime>(i).seconds; }
+    // Та же клетка 16x16, что у фасада Fruit, без его создания
+    SDL_Rect itemHitbox(size_t i) const {
+        const Tile& tile = items.get<Tile>(i);
+        return SDL_Rect{tile.x * 16, tile.y * 16, 16, 16};
+    }
+
+    // Система времени жизни: предметы, у которых оно вышло, удаляются
+    void expireItems(float deltaTime);
+
+    // Фрукт в ключевом кадре: положение в формате GameObject::saveMotion и
+    // оставшееся время
+    void saveFruit(size_t i, std::vector<uint8_t>& out) const;
+    bool restoreFruit(ByteReader& in, FruitType type, SDL_Texture* icon);
+
+    const PoolStats& getCellStats() const { return cells.getStats(); }
+    const PoolStats& getItemStats() const { return items.getStats(); }
+
+private:
+    int width = 0;
+    std::vector<uint8_t> kinds;
+    // Номер сущности в cells для каждой клетки с точкой
+    std::vector<uint32_t> cellEntity;
+    Archetype<256, Tile, Pickup> cells;
+    Archetype<4, Tile, Position, Sprite, Pickup, Lifetime, FruitInfo> items;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include "StateStream.h"
+
+// Клетки, которые Пакман подбирает: вид хранится байтом PelletKind в сетке
+// уровня, зрителям уходит кодом StreamCell. Новый вид (бонус и т.п.) -
+// значение PelletKind, код StreamCell и строка в kPickupRules: разбор
+// карты, поедание, сохранение, автопилот, поток состояния и PelletLayer
+// читают таблицу и сами не меняются
+enum PelletKind : uint8_t { PELLET_NONE = 0, PELLET_DOT = 1, PELLET_ENERGIZER = 2, PELLET_KIND_COUNT };
+
+struct PickupRule {
+    char symbol;          // символ в файле уровня
+    int points;
+    bool frightensGhosts;
+    StreamCell cell;      // код клетки в потоке состояния и снимке кадра
+    const char* sprite;
+    // Мигающие клетки рисуются поверх слоя точек каждый кадр (см. PelletLayer)
+    bool blinks;
+};
+
+const PickupRule kPickupRules[PELLET_KIND_COUNT] = {
+    {'\0', 0, false, STREAM_EMPTY, nullptr, false},
+    {'.', 10, false, STREAM_DOT, "sprites/map/big-1.png", false},
+    {'o', 50, true, STREAM_ENERGIZER, "sprites/map/big-0.png", true},
+};
+
+inline PelletKind pelletKindFor(char symbol) {
+    for (int kind = PELLET_NONE + 1; kind < PELLET_KIND_COUNT; ++kind) {
+        if (kPickupRules[kind].symbol == symbol) return static_cast<PelletKind>(kind);
+    }
+    return PELLET_NONE;
+}
+
+// Вид по коду StreamCell; PELLET_NONE - пусто, стена или неизвестный код
+inline PelletKind pelletKindForCell(uint8_t cell) {
+    for (int kind = PELLET_NONE + 1; kind < PELLET_KIND_COUNT; ++kind) {
+        if (kPickupRules[kind].cell == cell) return static_cast<PelletKind>(kind);
+    }
+    return PELLET_NONE;
+}
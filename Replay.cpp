@@ -0,0 +1,364 @@
+#include "Replay.h"
+#include "Level.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const char kMagic[4] = {'P', 'M', 'R', 'P'};
+    const char kIndexMagic[4] = {'P', 'M', 'R', 'X'};
+    const uint8_t kVersion = 3;
+    const uint8_t kKeyframeForced = 1;
+    const uint8_t kKeyframe = 'K';
+    const uint8_t kInputs = 'I';
+    // u64 смещение оглавления и метка в самом конце файла
+    const uint64_t kTrailerSize = 12;
+    // Заголовок блока: тип и длина varint
+    const size_t kMaxChunkHeader = 11;
+    const size_t kMaxHeader = 1 << 20;
+
+    bool readAt(std::ifstream& file, uint64_t at, size_t count, std::vector<uint8_t>& out) {
+        out.resize(count);
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(at));
+        file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(count));
+        return static_cast<size_t>(file.gcount()) == count;
+    }
+}
+
+// ReplayWriter
+
+ReplayWriter::~ReplayWriter() {
+    close();
+}
+
+bool ReplayWriter::open(const std::string& path, const Level& level, uint32_t interval) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to create replay " << path << std::endl;
+        return false;
+    }
+
+    keyframeInterval = std::max<uint32_t>(interval, 1);
+    offset = 0;
+    tick = 0;
+    keyframePending = false;
+    index.clear();
+    inputs.clear();
+    inputsStart = lastInputTick = 0;
+
+    std::vector<uint8_t> header(kMagic, kMagic + 4);
+    header.push_back(kVersion);
+    putVarint(header, keyframeInterval);
+    putVarint(header, level.getLevelPath().size());
+    header.insert(header.end(), level.getLevelPath().begin(), level.getLevelPath().end());
+    putVarint(header, level.getLevelText().size());
+    header.insert(header.end(), level.getLevelText().begin(), level.getLevelText().end());
+    // Правила уровня (v3): скорость в процентах, биты float времени страха, фрукты
+    const LevelRules& rules = level.getRules();
+    uint32_t frightenedBits;
+    std::memcpy(&frightenedBits, &rules.frightenedSeconds, sizeof(frightenedBits));
+    putVarint(header, static_cast<uint32_t>(rules.speedPercent));
+    putVarint(header, frightenedBits);
+    putVarint(header, rules.fruits.size());
+    for (FruitType fruit : rules.fruits) header.push_back(static_cast<uint8_t>(fruit));
+    write(header);
+    return true;
+}
+
+void ReplayWriter::write(const std::vector<uint8_t>& bytes) {
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    offset += bytes.size();
+}
+
+void ReplayWriter::writeChunk(uint8_t type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> header{type};
+    putVarint(header, data.size());
+    write(header);
+    write(data);
+}
+
+void ReplayWriter::flushInputs() {
+    if (tick > inputsStart) {
+        payload.clear();
+        putVarint(payload, inputsStart);
+        putVarint(payload, tick - inputsStart);
+        payload.insert(payload.end(), inputs.begin(), inputs.end());
+        writeChunk(kInputs, payload);
+        // Запись читаема и во время игры, падение теряет не больше отрезка
+        file.flush();
+    }
+    inputs.clear();
+    inputsStart = lastInputTick = tick;
+}
+
+void ReplayWriter::recordTick(const Level& level, Direction input) {
+    if (!file.is_open()) return;
+
+    if (tick % keyframeInterval == 0 || keyframePending) {
+        flushInputs();
+        index.push_back({tick, offset});
+        payload.clear();
+        putVarint(payload, tick);
+        payload.push_back(keyframePending ? kKeyframeForced : 0);
+        const uint64_t hash = level.getStateHash();
+        for (int i = 0; i < 8; ++i) payload.push_back(static_cast<uint8_t>(hash >> (8 * i)));
+        level.saveState(payload);
+        writeChunk(kKeyframe, payload);
+        keyframePending = false;
+    }
+    if (input != Direction::NONE) {
+        putVarint(inputs, tick - lastInputTick);
+        inputs.push_back(static_cast<uint8_t>(input));
+        lastInputTick = tick;
+    }
+    tick++;
+
+    if (!file) {
+        std::cerr << "Replay write failed, recording stopped" << std::endl;
+        file.close();
+    }
+}
+
+void ReplayWriter::close() {
+    if (!file.is_open()) return;
+    flushInputs();
+
+    const uint64_t indexOffset = offset;
+    payload.clear();
+    putVarint(payload, tick);
+    putVarint(payload, index.size());
+    uint64_t lastTick = 0, lastOffset = 0;
+    for (const IndexEntry& entry : index) {
+        putVarint(payload, entry.tick - lastTick);
+        putVarint(payload, entry.offset - lastOffset);
+        lastTick = entry.tick;
+        lastOffset = entry.offset;
+    }
+    for (int i = 0; i < 8; ++i) payload.push_back(static_cast<uint8_t>(indexOffset >> (8 * i)));
+    payload.insert(payload.end(), kIndexMagic, kIndexMagic + 4);
+    write(payload);
+    file.close();
+}
+
+// ReplayReader
+
+bool ReplayReader::open(const std::string& path) {
+    file.close();
+    file.open(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open replay " << path << std::endl;
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    fileSize = static_cast<uint64_t>(file.tellg());
+    index.clear();
+    tickCount = 0;
+    desyncCount = 0;
+    positioned = false;
+
+    std::vector<uint8_t> header;
+    readAt(file, 0, static_cast<size_t>(std::min<uint64_t>(fileSize, kMaxHeader)), header);
+    ByteReader in{header.data(), header.size(), 0};
+    size_t pathSize, textSize;
+    if (header.size() < 5 || std::memcmp(header.data(), kMagic, 4) != 0 || !in.skip(4) ||
+        !in.byte(version) || version < 1 || version > kVersion || !in.varint(keyframeInterval) ||
+        !in.varint(pathSize) || !in.skip(pathSize)) {
+        std::cerr << "Not a replay file: " << path << std::endl;
+        return false;
+    }
+    levelPath.assign(reinterpret_cast<const char*>(&header[in.pos - pathSize]), pathSize);
+    if (!in.varint(textSize) || !in.skip(textSize)) {
+        std::cerr << "Not a replay file: " << path << std::endl;
+        return false;
+    }
+    levelText.assign(reinterpret_cast<const char*>(&header[in.pos - textSize]), textSize);
+    rules = LevelRules();
+    if (version >= 3 && !readRules(in)) {
+        std::cerr << "Not a replay file: " << path << std::endl;
+        return false;
+    }
+
+    if (!readIndex(in.pos)) {
+        std::cout << "Replay " << path << " has no index, scanning" << std::endl;
+        scanChunks(in.pos);
+    }
+    if (index.empty()) {
+        std::cerr << "Replay " << path << " has no keyframes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReplayReader::readRules(ByteReader& in) {
+    uint32_t speedPercent, frightenedBits;
+    size_t fruitCount;
+    if (!in.varint(speedPercent) || !in.varint(frightenedBits) || !in.varint(fruitCount) ||
+        speedPercent == 0 || fruitCount > in.size - in.pos) {
+        return false;
+    }
+    rules.speedPercent = static_cast<int>(speedPercent);
+    std::memcpy(&rules.frightenedSeconds, &frightenedBits, sizeof(frightenedBits));
+    for (size_t i = 0; i < fruitCount; ++i) {
+        uint8_t fruit;
+        if (!in.byte(fruit) || fruit >= kFruitTypeCount) return false;
+        rules.fruits.push_back(static_cast<FruitType>(fruit));
+    }
+    return true;
+}
+
+bool ReplayReader::readIndex(uint64_t dataStart) {
+    std::vector<uint8_t> trailer;
+    if (fileSize < dataStart + kTrailerSize || !readAt(file, fileSize - kTrailerSize, kTrailerSize, trailer) ||
+        std::memcmp(&trailer[8], kIndexMagic, 4) != 0) {
+        return false;
+    }
+    uint64_t indexOffset = 0;
+    for (int i = 0; i < 8; ++i) indexOffset |= static_cast<uint64_t>(trailer[i]) << (8 * i);
+    if (indexOffset < dataStart || indexOffset > fileSize - kTrailerSize) return false;
+
+    std::vector<uint8_t> data;
+    if (!readAt(file, indexOffset, static_cast<size_t>(fileSize - kTrailerSize - indexOffset), data)) return false;
+    ByteReader in{data.data(), data.size(), 0};
+    size_t count;
+    if (!in.varint(tickCount) || !in.varint(count)) return false;
+    uint64_t tick = 0, offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t tickDelta, offsetDelta;
+        if (!in.varint(tickDelta) || !in.varint(offsetDelta)) return false;
+        tick += tickDelta;
+        offset += offsetDelta;
+        if (offset < dataStart || offset >= indexOffset) return false;
+        index.push_back({tick, offset});
+    }
+    return true;
+}
+
+void ReplayReader::scanChunks(uint64_t from) {
+    index.clear();
+    tickCount = 0;
+    uint64_t at = from;
+    uint8_t type;
+    uint64_t next;
+    while (readChunk(at, type, next)) {
+        ByteReader in{chunk.data(), chunk.size(), 0};
+        uint64_t tick, count;
+        if (type == kKeyframe && in.varint(tick)) {
+            index.push_back({tick, at});
+        } else if (type == kInputs && in.varint(tick) && in.varint(count)) {
+            tickCount = std::max(tickCount, tick + count);
+        }
+        at = next;
+    }
+}
+
+bool ReplayReader::readChunk(uint64_t at, uint8_t& type, uint64_t& next) {
+    if (at >= fileSize) return false;
+    std::vector<uint8_t> header;
+    if (!readAt(file, at, static_cast<size_t>(std::min<uint64_t>(kMaxChunkHeader, fileSize - at)), header)) return false;
+    ByteReader in{header.data(), header.size(), 0};
+    uint64_t size;
+    if (!in.byte(type) || !in.varint(size) || size > fileSize - at - in.pos) return false;
+    next = at + in.pos + size;
+    return readAt(file, at + in.pos, static_cast<size_t>(size), chunk);
+}
+
+bool ReplayReader::loadSegment(size_t entry) {
+    segment = entry;
+    segmentEnd = index[entry].tick;
+    inputs.clear();
+    inputCursor = 0;
+
+    // Сразу за ключевым кадром - блок ввода до следующего кадра
+    uint8_t type;
+    uint64_t next;
+    if (!readChunk(index[entry].offset, type, next) || type != kKeyframe) return false;
+    if (!readChunk(next, type, next) || type != kInputs) return true;
+
+    ByteReader in{chunk.data(), chunk.size(), 0};
+    uint64_t start, count;
+    if (!in.varint(start) || !in.varint(count) || start != index[entry].tick) return false;
+    uint64_t tick = start;
+    while (in.pos < in.size) {
+        uint64_t delta;
+        uint8_t dir;
+        if (!in.varint(delta) || !in.byte(dir) || dir >= static_cast<uint8_t>(Direction::NONE)) return false;
+        tick += delta;
+        inputs.push_back({tick, static_cast<Direction>(dir)});
+    }
+    segmentEnd = start + count;
+    return true;
+}
+
+bool ReplayReader::seek(Level& level, uint64_t tick) {
+    if (index.empty()) return false;
+    tick = std::min(tick, tickCount);
+
+    auto it = std::upper_bound(index.begin(), index.end(), tick,
+                               [](uint64_t value, const IndexEntry& entry) { return value < entry.tick; });
+    if (it == index.begin()) return false;
+    const size_t entry = static_cast<size_t>(it - index.begin()) - 1;
+
+    // Вперёд в пределах отрезка выгоднее досимулировать от текущего тика
+    if (!positioned || position > tick || position < index[entry].tick) {
+        if (!restoreKeyframe(level, entry)) return false;
+    }
+
+    while (position < tick) {
+        if (!step(level)) return false;
+    }
+    return true;
+}
+
+bool ReplayReader::restoreKeyframe(Level& level, size_t entry, bool checkHash) {
+    positioned = false;
+    uint8_t type;
+    uint64_t next;
+    if (!readChunk(index[entry].offset, type, next) || type != kKeyframe) return false;
+    ByteReader in{chunk.data(), chunk.size(), 0};
+    uint64_t keyTick;
+    if (!in.varint(keyTick) || keyTick != index[entry].tick) return false;
+    if (version >= 2) {
+        uint8_t flags, hashByte;
+        uint64_t hash = 0;
+        if (!in.byte(flags)) return false;
+        for (int i = 0; i < 8; ++i) {
+            if (!in.byte(hashByte)) return false;
+            hash |= static_cast<uint64_t>(hashByte) << (8 * i);
+        }
+        if (checkHash && !(flags & kKeyframeForced) && hash != level.getStateHash()) {
+            if (desyncCount++ == 0) {
+                std::cerr << "Replay desync at tick " << keyTick << ": state hash " << std::hex
+                          << level.getStateHash() << ", recorded " << hash << std::dec << std::endl;
+            }
+        }
+    }
+    if (!level.restoreState(chunk.data() + in.pos, chunk.size() - in.pos)) {
+        std::cerr << "Corrupted replay keyframe at tick " << keyTick << std::endl;
+        return false;
+    }
+    if (!loadSegment(entry)) return false;
+    position = keyTick;
+    positioned = true;
+    return true;
+}
+
+bool ReplayReader::step(Level& level) {
+    if (!positioned || position >= tickCount || position >= segmentEnd) return false;
+
+    while (inputCursor < inputs.size() && inputs[inputCursor].tick == position) {
+        level.getPacman()->setNextDirection(inputs[inputCursor].dir);
+        inputCursor++;
+    }
+    level.tick();
+    position++;
+
+    // Ключевой кадр восстанавливается и на границе отрезков: внеочередной
+    // кадр после перемотки назад не следует из досимулированного состояния
+    if (position == segmentEnd && segment + 1 < index.size() && index[segment + 1].tick == position) {
+        return restoreKeyframe(level, segment + 1, true);
+    }
+    return true;
+}
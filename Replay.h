@@ -0,0 +1,139 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Level.h"
+
+struct ByteReader;
+
+// Запись игры: ключевые кадры полного состояния Level (Level::saveState)
+// каждые N тиков, между ними - ввод, то есть направления, переданные
+// Пакману, с номерами тиков. Перемотка к любому тику - ближайший ключевой
+// кадр не позже него и досимуляция не больше N тиков. После перемотки
+// назад во время игры состояние не следует из ввода, поэтому на этом тике
+// пишется внеочередной ключевой кадр.
+//
+// Файл пишется потоком, блоками по мере игры, и после каждого блока ввода
+// сбрасывается на диск. Оглавление с ключевыми кадрами дописывается в конец
+// при закрытии; файл без оглавления (игра упала) читается сканированием
+// блоков. Хэш состояния в ключевом кадре сверяется с досимулированным
+// состоянием: расхождение значит, что симуляция недетерминирована (другая
+// сборка, машина или ошибка). В версии 1 флагов и хэша нет.
+// Целые - varint (см. Varint.h):
+//   заголовок:  "PMRP", u8 версия, интервал ключевых кадров,
+//               длина и имя карты, длина и текст карты; с версии 3 -
+//               LevelRules: скорость в процентах, биты float времени
+//               страха, число фруктов и u8 на фрукт
+//   блок:       u8 тип, длина данных, данные
+//     'K' ключевой кадр: тик, u8 флаги (1 - внеочередной), u64 хэш
+//                        Level::getStateHash, Level::saveState
+//     'I' ввод:          первый тик, число тиков, пары (разность тиков
+//                        с предыдущим вводом, u8 направление)
+//   оглавление: число тиков, число ключевых кадров и для каждого разности
+//               тика и смещения блока; затем u64 смещение оглавления и "PMRX"
+class ReplayWriter {
+public:
+    static const uint32_t kDefaultKeyframeInterval = 300; // 5 с игры
+
+    ReplayWriter() = default;
+    ~ReplayWriter();
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    // level - загруженный уровень, с его карты начнётся запись
+    bool open(const std::string& path, const Level& level, uint32_t keyframeInterval = kDefaultKeyframeInterval);
+    // Перед каждым тиком: level - состояние до тика, input - направление,
+    // которое Пакман получит на этом тике (NONE - ввода не было)
+    void recordTick(const Level& level, Direction input);
+    // Состояние level изменилось не тиком (перемотка назад): следующий
+    // recordTick запишет ключевой кадр
+    void forceKeyframe() { keyframePending = true; }
+    // Дописывает последний блок ввода и оглавление
+    void close();
+
+    bool isOpen() const { return file.is_open(); }
+    uint64_t getTickCount() const { return tick; }
+
+private:
+    struct IndexEntry {
+        uint64_t tick;
+        uint64_t offset;
+    };
+
+    std::ofstream file;
+    uint64_t offset = 0;
+    uint32_t keyframeInterval = kDefaultKeyframeInterval;
+    uint64_t tick = 0;
+    bool keyframePending = false;
+    std::vector<IndexEntry> index;
+
+    uint64_t inputsStart = 0;
+    uint64_t lastInputTick = 0;
+    std::vector<uint8_t> inputs;
+    std::vector<uint8_t> payload;
+
+    void write(const std::vector<uint8_t>& bytes);
+    void writeChunk(uint8_t type, const std::vector<uint8_t>& data);
+    void flushInputs();
+};
+
+class ReplayReader {
+public:
+    bool open(const std::string& path);
+
+    const std::string& getLevelPath() const { return levelPath; }
+    const std::string& getLevelText() const { return levelText; }
+    // Правила уровня; у повторов до v3 - по умолчанию
+    const LevelRules& getRules() const { return rules; }
+    uint64_t getTickCount() const { return tickCount; }
+    // Сколько тиков сыграно в level после последнего seek/step
+    uint64_t getPosition() const { return position; }
+    // Сколько ключевых кадров не совпало по хэшу с досимулированным состоянием
+    uint64_t getDesyncCount() const { return desyncCount; }
+
+    // level загружен из getLevelText(). Восстанавливает ближайший ключевой
+    // кадр не позже tick и досимулирует до tick
+    bool seek(Level& level, uint64_t tick);
+    // Один тик с записанным вводом; false - запись кончилась
+    bool step(Level& level);
+
+private:
+    struct IndexEntry {
+        uint64_t tick;
+        uint64_t offset;
+    };
+    struct Input {
+        uint64_t tick;
+        Direction dir;
+    };
+
+    std::ifstream file;
+    uint64_t fileSize = 0;
+    std::string levelPath;
+    std::string levelText;
+    LevelRules rules;
+    uint8_t version = 0;
+    uint32_t keyframeInterval = 0;
+    uint64_t tickCount = 0;
+    uint64_t desyncCount = 0;
+    std::vector<IndexEntry> index;
+
+    // Ввод отрезка между текущим ключевым кадром и следующим
+    size_t segment = 0;
+    uint64_t segmentEnd = 0;
+    std::vector<Input> inputs;
+    size_t inputCursor = 0;
+    uint64_t position = 0;
+    bool positioned = false;
+
+    std::vector<uint8_t> chunk;
+
+    bool readChunk(uint64_t at, uint8_t& type, uint64_t& next);
+    bool readRules(ByteReader& in);
+    bool readIndex(uint64_t dataEnd);
+    void scanChunks(uint64_t from);
+    // checkHash - level досимулирован до кадра и должен с ним совпасть
+    bool restoreKeyframe(Level& level, size_t entry, bool checkHash = false);
+    bool loadSegment(size_t entry);
+};
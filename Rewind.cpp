@@ -0,0 +1,39 @@
+#include "Rewind.h"
+#include "Level.h"
+
+RewindBuffer::RewindBuffer() : slots(kCapacity) {}
+
+void RewindBuffer::capture(const Level& level) {
+    if (ticksSinceSnapshot++ % kSnapshotTicks != 0) return;
+    std::vector<uint8_t>& slot = slots[head];
+    slot.clear();
+    level.saveState(slot);
+    head = (head + 1) % kCapacity;
+    if (count < kCapacity) count++;
+}
+
+bool RewindBuffer::rewind(Level& level) {
+    if (count == 0) return false;
+    head = (head + kCapacity - 1) % kCapacity;
+    count--;
+    ticksSinceSnapshot = 0;
+    const std::vector<uint8_t>& slot = slots[head];
+    if (!level.restoreState(slot.data(), slot.size())) {
+        // Снимок своего же уровня не может не прочитаться; если всё же
+        // случилось - история бесполезна
+        clear();
+        return false;
+    }
+    return true;
+}
+
+void RewindBuffer::clear() {
+    count = 0;
+    ticksSinceSnapshot = 0;
+}
+
+size_t RewindBuffer::getBytes() const {
+    size_t bytes = 0;
+    for (const std::vector<uint8_t>& slot : slots) bytes += slot.capacity();
+    return bytes;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FixedPoint.h"
+
+class Level;
+
+// История для перемотки назад: кольцо снимков Level::saveState, по одному
+// на kSnapshotTicks тиков, на kSeconds секунд игры. Слоты создаются один
+// раз и переиспользуют свои буферы, поэтому после первого круга снимок не
+// выделяет память, а объём истории ограничен числом слотов.
+class RewindBuffer {
+public:
+    static const int kSnapshotTicks = 4;
+    static const int kSeconds = 10;
+    static const size_t kCapacity = kSeconds * kTicksPerSecond / kSnapshotTicks;
+
+    RewindBuffer();
+
+    // Перед каждым тиком; снимок пишется раз в kSnapshotTicks вызовов
+    void capture(const Level& level);
+    // Восстанавливает последний снимок и убирает его из истории, следующий
+    // capture снимет это же состояние заново. false - история пуста
+    bool rewind(Level& level);
+    void clear();
+
+    size_t size() const { return count; }
+    // Сколько секунд игры можно отмотать
+    float getSeconds() const { return count * kSnapshotTicks * kTickSeconds; }
+    size_t getBytes() const;
+
+private:
+    std::vector<std::vector<uint8_t>> slots;
+    size_t head = 0;  // слот под следующий снимок
+    size_t count = 0;
+    int ticksSinceSnapshot = 0;
+};
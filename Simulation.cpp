@@ -0,0 +1,253 @@
+#include "Simulation.h"
+#include "AssetManager.h"
+#include "Level.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+Simulation::Simulation(AssetManager& assets, JobSystem* jobs, StateBroadcaster* broadcaster)
+    : assets(assets), broadcaster(broadcaster), level(std::make_unique<Level>(nullptr, assets)), jobs(jobs) {
+    level->setJobSystem(jobs);
+    level->setStateStream(broadcaster);
+}
+
+Simulation::~Simulation() {
+    stop();
+}
+
+bool Simulation::load(const std::string& levelPath) {
+    if (Campaign::isManifest(levelPath)) {
+        if (!campaign.load(levelPath, assets)) return false;
+        const Campaign::Entry& first = campaign.getEntry(0);
+        if (!level->loadFromFile(first.map)) return false;
+        level->setRules(first.rules);
+        campaignIndex = 0;
+        if (campaign.size() > 1) {
+            level->setHoldClearedRound(true);
+            campaign.preload(1);
+        }
+        std::cout << "Campaign " << campaign.getName() << ": level 1/" << campaign.size() << std::endl;
+    } else if (!level->loadFromFile(levelPath)) {
+        return false;
+    }
+    watchLevel();
+    // Первый снимок есть ещё до старта потока, рисовать можно сразу
+    publishFrame();
+    frames.acquire();
+    return true;
+}
+
+void Simulation::setAutopilot(const Autopilot::Config& config) {
+    autopilot = std::make_unique<Autopilot>(config, jobs);
+    autopilotBudgetMs = config.budgetMs;
+    appliedScale = 1.0f;
+    applyTimeScale(getTimeScale());
+}
+
+bool Simulation::record(const std::string& path) {
+    if (!recorder.open(path, *level)) return false;
+    std::cout << "Recording replay to " << path << std::endl;
+    return true;
+}
+
+void Simulation::setTimeScale(float scale) {
+    timeScale.store(std::clamp(scale, kMinTimeScale, kMaxTimeScale), std::memory_order_relaxed);
+}
+
+void Simulation::applyTimeScale(float scale) {
+    if (scale == appliedScale) return;
+    appliedScale = scale;
+    if (autopilot) autopilot->setBudget(autopilotBudgetMs / std::max(1.0f, scale));
+}
+
+void Simulation::start(double startTimeMs) {
+    stop();
+    simTimeMs = startTimeMs;
+    rateWindowStart = static_cast<Uint32>(startTimeMs);
+    rateWindowTicks = tickCount;
+    stopRequested.store(false, std::memory_order_relaxed);
+    thread = std::thread(&Simulation::threadLoop, this);
+}
+
+void Simulation::stop() {
+    stopRequested.store(true, std::memory_order_release);
+    if (thread.joinable()) thread.join();
+}
+
+void Simulation::pushInput(Uint32 timestamp, Direction dir) {
+    std::lock_guard<std::mutex> lock(inputMutex);
+    pendingInputs.push_back({timestamp, dir});
+}
+
+Direction Simulation::takeInput() {
+    // Из нескольких нажатий за тик действует последнее
+    Direction dir = Direction::NONE;
+    std::lock_guard<std::mutex> lock(inputMutex);
+    while (!pendingInputs.empty() && pendingInputs.front().timestamp <= simTimeMs) {
+        dir = pendingInputs.front().dir;
+        pendingInputs.pop_front();
+    }
+    return dir;
+}
+
+void Simulation::tick(double tickWallMs) {
+    simTimeMs += tickWallMs;
+    Direction input = takeInput();
+    if (autopilot) {
+        Direction dir = autopilot->decide(*level);
+        if (dir != Direction::NONE) input = dir;
+    }
+    history.capture(*level);
+    recorder.recordTick(*level, input);
+    if (input != Direction::NONE) level->getPacman()->setNextDirection(input);
+    level->tick();
+    tickCount++;
+    // Очищенная карта не перестраивается: её сразу сменяет заранее
+    // собранный следующий уровень
+    if (level->isRoundCleared()) advanceCampaign();
+}
+
+void Simulation::advanceCampaign() {
+    std::unique_ptr<Level> next = campaign.takePreloaded();
+    if (!next) {
+        // Следующий уровень не собрался - играем дальше на текущем
+        std::cerr << "Campaign level failed to load, staying on current level" << std::endl;
+        level->restartLevel(true);
+        return;
+    }
+    campaignIndex = (campaignIndex + 1) % campaign.size();
+    next->continueFrom(*level);
+    next->setHoldClearedRound(true);
+    next->setJobSystem(jobs);
+    next->setStateStream(broadcaster);
+    level = std::move(next);
+    campaign.preload((campaignIndex + 1) % campaign.size());
+
+    watchLevel();
+
+    // Снимки истории и повтор относятся к прошлой карте
+    history.clear();
+    stopRecording("level change");
+    std::cout << "Campaign level " << campaignIndex + 1 << "/" << campaign.size() << std::endl;
+}
+
+void Simulation::stopRecording(const char* reason) {
+    if (!recorder.isOpen()) return;
+    recorder.close();
+    std::cout << "Replay recording stopped at " << reason << std::endl;
+}
+
+void Simulation::watchLevel() {
+    const std::string& path = level->getLevelPath();
+    const size_t slash = path.find_last_of('/');
+    levelWatcher.watch(slash == std::string::npos ? std::string() : path.substr(0, slash));
+}
+
+bool Simulation::reloadChangedLevels() {
+    bool reloaded = false;
+    bool anyChanged = false;
+    for (const std::string& path : levelWatcher.poll()) {
+        std::string text;
+        // Новое содержимое запоминается и для следующих загрузок этого файла
+        if (!assets.reloadText(path, text)) continue;
+        anyChanged = true;
+        if (path != level->getLevelPath() || text == level->getLevelText()) continue;
+
+        const Uint64 start = SDL_GetPerformanceCounter();
+        const int cells = level->reloadFromText(text);
+        const double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+        if (cells < 0) {
+            std::cout << "Reloaded " << path << ": map rebuilt as a new round";
+        } else {
+            std::cout << "Reloaded " << path << ": " << cells << " cells changed";
+        }
+        std::cout << " in " << ms << " ms" << std::endl;
+
+        // Снимки истории и повтор записаны по старой карте
+        history.clear();
+        stopRecording("level reload");
+        reloaded = true;
+    }
+    // Следующий уровень кампании мог собраться из старого файла
+    if (anyChanged && campaign.size() > 1) campaign.preload((campaignIndex + 1) % campaign.size());
+    return reloaded;
+}
+
+void Simulation::rewindTick(double tickWallMs) {
+    simTimeMs += tickWallMs;
+    takeInput();
+    if (++rewindTicks < RewindBuffer::kSnapshotTicks) return;
+    rewindTicks = 0;
+    if (history.rewind(*level)) {
+        // В повторе отмотанное состояние не следует из ввода
+        recorder.forceKeyframe();
+    }
+}
+
+void Simulation::publishFrame() {
+    FrameSnapshot& frame = frames.back();
+    level->captureFrame(frame);
+    frame.tick = tickCount;
+    frame.timeScale = appliedScale;
+    frame.tickRate = tickRate;
+    frame.rewinding = rewindRequested.load(std::memory_order_relaxed);
+    frame.rewindSeconds = history.getSeconds();
+    frames.publish();
+}
+
+void Simulation::threadLoop() {
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        const float scale = getTimeScale();
+        applyTimeScale(scale);
+        const double tickWallMs = kTickMs / scale;
+        const int maxTicks = static_cast<int>(kMaxTicksPerWake * std::max(1.0f, scale));
+
+        const Uint32 now = SDL_GetTicks();
+        int ticks = 0;
+        const bool rewinding = rewindRequested.load(std::memory_order_relaxed);
+        if (!rewinding) rewindTicks = 0;
+        while (simTimeMs + tickWallMs <= now && ticks < maxTicks) {
+            if (rewinding) {
+                rewindTick(tickWallMs);
+            } else {
+                tick(tickWallMs);
+            }
+            ticks++;
+            if (level->isGameOver()) break;
+        }
+
+        // После долгой паузы (сон системы и т.п.) или если тики не успевают
+        // за ускорением - не навёрстываем время
+        if (ticks == maxTicks && simTimeMs + tickWallMs <= now) {
+            simTimeMs = now;
+        }
+
+        if (now - rateWindowStart >= kRateWindowMs) {
+            tickRate = (tickCount - rateWindowTicks) * 1000.0f / (now - rateWindowStart);
+            rateWindowStart = now;
+            rateWindowTicks = tickCount;
+        }
+
+        bool changed = ticks > 0;
+        if (now - lastWatchPoll >= kWatchPollMs) {
+            lastWatchPoll = now;
+            changed |= reloadChangedLevels();
+        }
+
+        if (changed) {
+            level->publishState();
+            publishFrame();
+        }
+        // Последний снимок с gameOver уже опубликован, дальше решает App
+        if (level->isGameOver()) {
+            recorder.close();
+            return;
+        }
+
+        double waitMs = simTimeMs + tickWallMs - SDL_GetTicks();
+        if (scale > 1.0f) waitMs = std::max(waitMs, kBatchWakeMs);
+        if (waitMs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(waitMs * 1000.0)));
+        }
+    }
+}
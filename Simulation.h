@@ -0,0 +1,137 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Autopilot.h"
+#include "Campaign.h"
+#include "FileWatcher.h"
+#include "FixedPoint.h"
+#include "FrameSnapshot.h"
+#include "Replay.h"
+#include "Rewind.h"
+#include "TripleBuffer.h"
+
+class AssetManager;
+class JobSystem;
+class Level;
+class StateBroadcaster;
+
+// Симуляция уровня в своём потоке. Поток идёт фиксированными тиками по
+// часам SDL_GetTicks и после тиков публикует снимок кадра в тройной буфер;
+// поток рендера берёт последний снимок и рисует его, не касаясь Level.
+// Поэтому долгий SDL_RenderPresent (vsync, композитор, GPU) не сдвигает
+// тики, а медленный кадр просто пропускает промежуточные снимки.
+//
+// Нажатия приходят с метками времени SDL и применяются на первом тике не
+// раньше своей метки, как и в однопоточном цикле.
+//
+// Масштаб времени (x0.25 - x64) меняет только частоту тиков, шаг тика
+// остаётся kTickSeconds. При ускорении поток просыпается пачками и
+// прогоняет десятки тиков подряд через Level::tick(), снимок и трансляция -
+// один раз за пачку.
+//
+// Пока зажата перемотка, тики не идут: каждые RewindBuffer::kSnapshotTicks
+// тиков по часам восстанавливается предыдущий снимок истории, то есть игра
+// отматывается с той же скоростью, с какой шла. После отпускания игра
+// продолжается с отмотанного места, нажатия за время перемотки отбрасываются.
+//
+// Если load получил манифест кампании, каждый её уровень - один раунд:
+// пока он идёт, следующий строится в фоне, а в конце раунда уровни
+// меняются местами между тиками. Запись повтора на смене уровня кончается.
+//
+// Каталог текущей карты отслеживается (FileWatcher): сохранённый в
+// редакторе файл уровня применяется между тиками через
+// Level::reloadFromText. Запись повтора на этом тоже кончается.
+class Simulation {
+public:
+    static constexpr double kTickMs = 1000.0 / kTicksPerSecond;
+    // Сколько тиков навёрстывается за одно пробуждение потока при x1
+    static constexpr int kMaxTicksPerWake = 8;
+    static constexpr float kMinTimeScale = 0.25f;
+    static constexpr float kMaxTimeScale = 64.0f;
+    // При ускорении поток спит не меньше этого, чтобы тики шли пачками
+    static constexpr double kBatchWakeMs = 4.0;
+    // Окно замера фактической частоты тиков
+    static constexpr Uint32 kRateWindowMs = 500;
+    // Как часто проверяются изменения файлов уровней
+    static constexpr Uint32 kWatchPollMs = 100;
+
+    // assets - без рендерера: поток симуляции не должен трогать GPU
+    Simulation(AssetManager& assets, JobSystem* jobs, StateBroadcaster* broadcaster);
+    ~Simulation();
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // levelPath - файл уровня или манифест кампании (*.json)
+    bool load(const std::string& levelPath);
+    void setAutopilot(const Autopilot::Config& config);
+    // Запись игры в файл повтора, после load и до start
+    bool record(const std::string& path);
+    // startTimeMs - время первого тика в шкале SDL_GetTicks
+    void start(double startTimeMs);
+    void stop();
+    // Можно вызывать на ходу из потока рендера
+    void setTimeScale(float scale);
+    float getTimeScale() const { return timeScale.load(std::memory_order_relaxed); }
+    // Пока true, игра отматывается назад; можно вызывать на ходу
+    void setRewinding(bool rewinding) { rewindRequested.store(rewinding, std::memory_order_relaxed); }
+
+    // Вызываются из потока рендера
+    void pushInput(Uint32 timestamp, Direction dir);
+    // true - появился новый снимок, getFrame() вернёт его
+    bool acquireFrame() { return frames.acquire(); }
+    const FrameSnapshot& getFrame() const { return frames.front(); }
+
+private:
+    struct InputEvent {
+        Uint32 timestamp;
+        Direction dir;
+    };
+
+    AssetManager& assets;
+    StateBroadcaster* broadcaster;
+    std::unique_ptr<Level> level;
+    Campaign campaign;
+    size_t campaignIndex = 0;
+    FileWatcher levelWatcher;
+    Uint32 lastWatchPoll = 0;
+    std::unique_ptr<Autopilot> autopilot;
+    ReplayWriter recorder;
+    RewindBuffer history;
+    int rewindTicks = 0;
+    JobSystem* jobs;
+    TripleBuffer<FrameSnapshot> frames;
+
+    std::mutex inputMutex;
+    std::deque<InputEvent> pendingInputs; // под inputMutex
+
+    std::thread thread;
+    std::atomic<bool> stopRequested{false};
+    std::atomic<float> timeScale{1.0f};
+    std::atomic<bool> rewindRequested{false};
+    double simTimeMs = 0.0;
+    uint64_t tickCount = 0;
+
+    // Бюджет автопилота делится на ускорение, иначе поиск не успевает за тиками
+    double autopilotBudgetMs = 0.0;
+    float appliedScale = 1.0f;
+
+    Uint32 rateWindowStart = 0;
+    uint64_t rateWindowTicks = 0;
+    float tickRate = 0.0f;
+
+    void threadLoop();
+    void tick(double tickWallMs);
+    void rewindTick(double tickWallMs);
+    void applyTimeScale(float scale);
+    void advanceCampaign();
+    void watchLevel();
+    bool reloadChangedLevels();
+    void stopRecording(const char* reason);
+    Direction takeInput();
+    void publishFrame();
+};
@@ -0,0 +1,116 @@
+// Зритель трансляции: подключается к сокету игры (app --broadcast <сокет>),
+// восстанавливает состояние по кадрам StateStream и рисует его. Сам игру не
+// симулирует, поэтому зрителей на одной машине может быть сколько угодно.
+//   spectator <сокет>
+#include "AssetManager.h"
+#include "FrameRenderer.h"
+#include "StateStream.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <iostream>
+#include <string>
+
+namespace {
+    const Uint32 kReconnectMs = 1000;
+
+    void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
+        if (!font) return;
+        SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
+        if (!surface) return;
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_Rect rect = {x, y, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, nullptr, &rect);
+        SDL_FreeSurface(surface);
+        SDL_DestroyTexture(texture);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: spectator <socket>" << std::endl;
+        return 1;
+    }
+    const std::string socketPath = argv[1];
+
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    if (TTF_Init() == -1 || (IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG) {
+        std::cerr << "SDL_ttf/SDL_image init failed" << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Window* window = SDL_CreateWindow("Pacman Spectator", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                          800, 600, SDL_WINDOW_SHOWN);
+    SDL_Renderer* renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)
+                                    : nullptr;
+    if (!renderer) {
+        std::cerr << "Failed to create window: " << SDL_GetError() << std::endl;
+        if (window) SDL_DestroyWindow(window);
+        IMG_Quit();
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    {
+        AssetManager assets(renderer);
+        if (!assets.openPack("assets.pak")) {
+            std::cout << "assets.pak not found, loading loose asset files" << std::endl;
+        }
+        assets.buildManifest({"sprites", "fonts"});
+        FrameRenderer frameRenderer(renderer, assets);
+        TTF_Font* font = assets.openFont("fonts/arial.ttf", 24);
+
+        StateReceiver receiver;
+        // Фруктов в трансляции нет, снимок несёт только состояние потока
+        FrameSnapshot frame;
+        StreamState& state = frame.world;
+        Uint32 lastAttempt = 0;
+        bool running = true;
+        while (running) {
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                if (event.type == SDL_QUIT) running = false;
+                if (event.type == SDL_RENDER_TARGETS_RESET) frameRenderer.invalidate();
+            }
+
+            const Uint32 now = SDL_GetTicks();
+            if (!receiver.isConnected() && (lastAttempt == 0 || now - lastAttempt >= kReconnectMs)) {
+                lastAttempt = now;
+                if (receiver.connect(socketPath)) {
+                    std::cout << "Connected to " << socketPath << std::endl;
+                }
+            }
+            if (receiver.isConnected() && !receiver.poll(state)) {
+                std::cout << "Game closed the stream" << std::endl;
+            }
+
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+            if (state.width > 0) {
+                // Номер тика растёт с каждым кадром потока: слой точек
+                // сверяется с клетками, только когда пришло новое состояние
+                frame.tick = state.tick;
+                frame.pelletVersion = static_cast<uint32_t>(state.tick);
+                frame.mouthOpen = (SDL_GetTicks() / 200) % 2 == 0;
+                frameRenderer.render(frame);
+            } else {
+                renderText(renderer, font, "Waiting for " + socketPath, 20, 20, {255, 255, 255, 255});
+            }
+            SDL_RenderPresent(renderer);
+        }
+
+        if (font) TTF_CloseFont(font);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    IMG_Quit();
+    TTF_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,369 @@
+#include "StateStream.h"
+#include "Pickups.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define STATESTREAM_HAS_SOCKETS 1
+#endif
+
+namespace {
+    const uint8_t kKeyframe = 'K';
+    const uint8_t kDelta = 'D';
+
+    // Маска изменений разностного кадра
+    const uint8_t kChangeScore = 1;
+    const uint8_t kChangeLives = 2;
+    const uint8_t kChangeEntities = 4;
+    const uint8_t kChangePellets = 8;
+
+    // Маска полей сущности
+    const uint8_t kFieldX = 1;
+    const uint8_t kFieldY = 2;
+    const uint8_t kFieldDir = 4;
+    const uint8_t kFieldFlags = 8;
+
+    // Больше кадра быть не может: карта до 255x255 и до 256 сущностей
+    const size_t kMaxFrameSize = 1 << 17;
+
+    void putEntity(std::vector<uint8_t>& out, const StreamEntity& entity) {
+        putSigned(out, entity.x);
+        putSigned(out, entity.y);
+        out.push_back(entity.dir);
+        out.push_back(entity.flags);
+    }
+
+    bool readEntity(ByteReader& in, StreamEntity& entity) {
+        int32_t x, y;
+        if (!in.signedVarint(x) || !in.signedVarint(y) || !in.byte(entity.dir) || !in.byte(entity.flags)) {
+            return false;
+        }
+        entity.x = static_cast<int16_t>(x);
+        entity.y = static_cast<int16_t>(y);
+        return true;
+    }
+}
+
+void StateEncoder::encodeKeyframe(const StreamState& state, std::vector<uint8_t>& out) {
+    out.clear();
+    out.push_back(kKeyframe);
+    putVarint(out, state.tick);
+    putVarint(out, static_cast<uint32_t>(state.width));
+    putVarint(out, static_cast<uint32_t>(state.height));
+    out.insert(out.end(), state.cells.begin(), state.cells.end());
+    putSigned(out, state.score);
+    putSigned(out, state.lives);
+    putVarint(out, static_cast<uint32_t>(state.entities.size()));
+    for (const StreamEntity& entity : state.entities) putEntity(out, entity);
+}
+
+bool StateEncoder::encodeDelta(const StreamState& previous, const StreamState& current, std::vector<uint8_t>& out) {
+    if (previous.width != current.width || previous.height != current.height ||
+        previous.cells.size() != current.cells.size() ||
+        previous.entities.size() != current.entities.size() || current.entities.size() > 256) {
+        return false;
+    }
+
+    out.clear();
+    out.push_back(kDelta);
+    putVarint(out, current.tick);
+    const size_t maskPos = out.size();
+    out.push_back(0);
+    uint8_t mask = 0;
+
+    if (current.score != previous.score) {
+        mask |= kChangeScore;
+        putSigned(out, current.score - previous.score);
+    }
+    if (current.lives != previous.lives) {
+        mask |= kChangeLives;
+        putSigned(out, current.lives);
+    }
+
+    size_t changed = 0;
+    for (size_t i = 0; i < current.entities.size(); ++i) {
+        changed += !(current.entities[i] == previous.entities[i]);
+    }
+    if (changed > 0) {
+        mask |= kChangeEntities;
+        putVarint(out, static_cast<uint32_t>(changed));
+        for (size_t i = 0; i < current.entities.size(); ++i) {
+            const StreamEntity& now = current.entities[i];
+            const StreamEntity& before = previous.entities[i];
+            if (now == before) continue;
+            uint8_t fields = (now.x != before.x ? kFieldX : 0) | (now.y != before.y ? kFieldY : 0) |
+                             (now.dir != before.dir ? kFieldDir : 0) | (now.flags != before.flags ? kFieldFlags : 0);
+            out.push_back(static_cast<uint8_t>(i));
+            out.push_back(fields);
+            if (fields & kFieldX) putSigned(out, now.x - before.x);
+            if (fields & kFieldY) putSigned(out, now.y - before.y);
+            if (fields & kFieldDir) out.push_back(now.dir);
+            if (fields & kFieldFlags) out.push_back(now.flags);
+        }
+    }
+
+    // Клетки между тиками меняются только тем, что подобрали точку или
+    // другой вид из kPickupRules; всё остальное (новый раунд, открытая
+    // дверь) - повод для ключевого кадра
+    size_t eaten = 0;
+    for (size_t cell = 0; cell < current.cells.size(); ++cell) {
+        const uint8_t before = previous.cells[cell];
+        const uint8_t now = current.cells[cell];
+        if (before == now) continue;
+        if (now != STREAM_EMPTY || pelletKindForCell(before) == PELLET_NONE) return false;
+        eaten++;
+    }
+    if (eaten > 0) {
+        mask |= kChangePellets;
+        putVarint(out, static_cast<uint32_t>(eaten));
+        size_t last = 0;
+        for (size_t cell = 0; cell < current.cells.size(); ++cell) {
+            if (previous.cells[cell] == current.cells[cell]) continue;
+            putVarint(out, static_cast<uint32_t>(cell - last));
+            last = cell;
+        }
+    }
+
+    out[maskPos] = mask;
+    return true;
+}
+
+bool StateDecoder::apply(const uint8_t* data, size_t size, StreamState& state) {
+    ByteReader in{data, size, 0};
+    uint8_t kind;
+    uint32_t tick;
+    if (!in.byte(kind) || !in.varint(tick)) return false;
+
+    if (kind == kKeyframe) {
+        uint32_t width, height, count;
+        if (!in.varint(width) || !in.varint(height) || width > 255 || height > 255) return false;
+        if (in.pos + static_cast<size_t>(width) * height > size) return false;
+        state.width = static_cast<int>(width);
+        state.height = static_cast<int>(height);
+        state.cells.assign(data + in.pos, data + in.pos + width * height);
+        in.pos += static_cast<size_t>(width) * height;
+        if (!in.signedVarint(state.score) || !in.signedVarint(state.lives) || !in.varint(count) || count > 256) {
+            synced = false;
+            return false;
+        }
+        state.entities.resize(count);
+        for (StreamEntity& entity : state.entities) {
+            if (!readEntity(in, entity)) {
+                synced = false;
+                return false;
+            }
+        }
+        state.tick = tick;
+        synced = true;
+        return true;
+    }
+
+    if (kind != kDelta || !synced || tick != state.tick + 1) return false;
+
+    // Разность применяется сразу к state: при ошибке в середине кадра
+    // состояние испорчено, и до ключевого кадра синхронизации нет
+    synced = false;
+    uint8_t mask;
+    if (!in.byte(mask)) return false;
+    if (mask & kChangeScore) {
+        int32_t diff;
+        if (!in.signedVarint(diff)) return false;
+        state.score += diff;
+    }
+    if ((mask & kChangeLives) && !in.signedVarint(state.lives)) return false;
+    if (mask & kChangeEntities) {
+        uint32_t count;
+        if (!in.varint(count)) return false;
+        for (uint32_t n = 0; n < count; ++n) {
+            uint8_t index, fields;
+            if (!in.byte(index) || !in.byte(fields) || index >= state.entities.size()) return false;
+            StreamEntity& entity = state.entities[index];
+            int32_t diff;
+            if (fields & kFieldX) {
+                if (!in.signedVarint(diff)) return false;
+                entity.x = static_cast<int16_t>(entity.x + diff);
+            }
+            if (fields & kFieldY) {
+                if (!in.signedVarint(diff)) return false;
+                entity.y = static_cast<int16_t>(entity.y + diff);
+            }
+            if ((fields & kFieldDir) && !in.byte(entity.dir)) return false;
+            if ((fields & kFieldFlags) && !in.byte(entity.flags)) return false;
+        }
+    }
+    if (mask & kChangePellets) {
+        uint32_t count, step;
+        size_t cell = 0;
+        if (!in.varint(count)) return false;
+        for (uint32_t n = 0; n < count; ++n) {
+            if (!in.varint(step)) return false;
+            cell += step;
+            if (cell >= state.cells.size()) return false;
+            state.cells[cell] = STREAM_EMPTY;
+        }
+    }
+    state.tick = tick;
+    synced = true;
+    return true;
+}
+
+StateBroadcaster::~StateBroadcaster() {
+    closeAll();
+}
+
+void StateBroadcaster::closeAll() {
+#ifdef STATESTREAM_HAS_SOCKETS
+    for (const Client& client : clients) ::close(client.fd);
+    if (listener >= 0) {
+        ::close(listener);
+        ::unlink(socketPath.c_str());
+    }
+#endif
+    clients.clear();
+    listener = -1;
+}
+
+bool StateBroadcaster::listen(const std::string& path) {
+    closeAll();
+#ifdef STATESTREAM_HAS_SOCKETS
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "State stream: socket path is too long: " << path << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    listener = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        std::cerr << "State stream: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // Сокет от прошлого запуска остаётся в файловой системе
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, 16) != 0) {
+        std::cerr << "State stream: cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(listener);
+        listener = -1;
+        return false;
+    }
+    socketPath = path;
+    hasPrevious = false;
+    return true;
+#else
+    std::cerr << "State stream: Unix sockets are not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+void StateBroadcaster::acceptClients() {
+#ifdef STATESTREAM_HAS_SOCKETS
+    for (;;) {
+        int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) break;
+        clients.push_back({fd, true});
+        std::cout << "Spectator connected (" << clients.size() << " watching)" << std::endl;
+    }
+#endif
+}
+
+void StateBroadcaster::publish() {
+    current.tick = tick++;
+    if (listener >= 0) {
+        acceptClients();
+
+        if (!clients.empty()) {
+            bool deltaReady = hasPrevious && StateEncoder::encodeDelta(previous, current, delta);
+            bool keyframeReady = false;
+            for (size_t i = 0; i < clients.size();) {
+                Client& client = clients[i];
+                const bool sendKeyframe = client.needsKeyframe || !deltaReady;
+                if (sendKeyframe && !keyframeReady) {
+                    StateEncoder::encodeKeyframe(current, keyframe);
+                    keyframeReady = true;
+                }
+                const std::vector<uint8_t>& frame = sendKeyframe ? keyframe : delta;
+#ifdef STATESTREAM_HAS_SOCKETS
+                ssize_t sent = ::send(client.fd, frame.data(), frame.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    client.needsKeyframe = true;
+                } else if (sent < 0) {
+                    ::close(client.fd);
+                    clients.erase(clients.begin() + i);
+                    std::cout << "Spectator disconnected (" << clients.size() << " watching)" << std::endl;
+                    continue;
+                } else {
+                    client.needsKeyframe = false;
+                    bytesSent += static_cast<uint64_t>(sent);
+                }
+#endif
+                ++i;
+            }
+        }
+    }
+
+    // Буферы меняются местами, память сущностей и клеток переиспользуется
+    std::swap(previous, current);
+    hasPrevious = true;
+}
+
+StateReceiver::~StateReceiver() {
+    disconnect();
+}
+
+void StateReceiver::disconnect() {
+#ifdef STATESTREAM_HAS_SOCKETS
+    if (fd >= 0) ::close(fd);
+#endif
+    fd = -1;
+    decoder = StateDecoder();
+}
+
+bool StateReceiver::connect(const std::string& path) {
+    disconnect();
+#ifdef STATESTREAM_HAS_SOCKETS
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    buffer.resize(kMaxFrameSize);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool StateReceiver::poll(StreamState& state) {
+    if (fd < 0) return false;
+#ifdef STATESTREAM_HAS_SOCKETS
+    for (;;) {
+        ssize_t size = ::recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (size > 0) {
+            decoder.apply(buffer.data(), static_cast<size_t>(size), state);
+            continue;
+        }
+        if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        if (size < 0 && errno == EINTR) continue;
+        disconnect();
+        return false;
+    }
+#else
+    return false;
+#endif
+}
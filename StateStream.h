@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Поток состояния игры для зрителей (второй экран, стена автоматов).
+// Хост после каждого тика публикует кадр, зритель восстанавливает по кадрам
+// состояние и рисует его сам, ничего не симулируя.
+//
+// Кадр - одно сообщение SOCK_SEQPACKET в Unix-сокете. Целые без знака -
+// varint (LEB128), со знаком - zigzag + varint:
+//   u8 тип ('K' - ключевой, 'D' - разностный), varint номер тика
+//   ключевой:   ширина, высота, клетки (по байту, StreamCell), счёт,
+//               жизни, число сущностей и каждая сущность целиком
+//               (x, y, u8 направление, u8 флаги)
+//   разностный: u8 маска изменений, затем по порядку только изменённое:
+//               разность счёта; жизни; число изменённых сущностей и для
+//               каждой u8 индекс, u8 маска полей и изменённые поля
+//               (разности x и y, направление, флаги); число съеденных
+//               точек и номера их клеток разностями по возрастанию
+// Всё, что не выражается разностью (новая карта, открытая дверь, другое
+// число сущностей), уходит ключевым кадром.
+struct StreamEntity {
+    int16_t x, y;    // центр в пикселях
+    uint8_t dir;     // Direction
+    uint8_t flags;   // StreamEntityFlag
+
+    bool operator==(const StreamEntity& other) const {
+        return x == other.x && y == other.y && dir == other.dir && flags == other.flags;
+    }
+};
+
+enum StreamCell : uint8_t { STREAM_EMPTY = 0, STREAM_DOT = 1, STREAM_ENERGIZER = 2, STREAM_WALL = 3 };
+
+enum StreamEntityFlag : uint8_t {
+    STREAM_ACTIVE = 1,     // Пакман: на поле; призрак: выпущен из загона
+    STREAM_POWERED = 2,    // Пакман под энерджайзером
+    STREAM_EATEN = 4,      // призрак съеден
+    STREAM_MODE_SHIFT = 4  // биты 4-5 у призрака - GhostMode
+};
+
+// Сущность 0 - Пакман, дальше призраки в порядке GhostSystem
+struct StreamState {
+    uint32_t tick = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> cells;  // StreamCell, построчно
+    int32_t score = 0;
+    int32_t lives = 0;
+    std::vector<StreamEntity> entities;
+};
+
+class StateEncoder {
+public:
+    static void encodeKeyframe(const StreamState& state, std::vector<uint8_t>& out);
+    // false - разностью не выразить, нужен ключевой кадр
+    static bool encodeDelta(const StreamState& previous, const StreamState& current, std::vector<uint8_t>& out);
+};
+
+class StateDecoder {
+public:
+    // Применяет кадр к state. Разностный кадр без предшествующего ключевого
+    // или не к тому тику отбрасывается (false), как и повреждённый кадр
+    bool apply(const uint8_t* data, size_t size, StreamState& state);
+    bool hasKeyframe() const { return synced; }
+
+private:
+    bool synced = false;
+};
+
+// Хост потока: слушает сокет, принимает зрителей и раздаёт им кадры.
+// Кадр кодируется один раз за тик и тем же буфером отправляется всем;
+// ключевой кадр строится только в тики, когда он кому-то нужен. Зритель,
+// который не успевает читать (переполнен буфер сокета), пропускает кадр и
+// получает следующий ключевым - симуляцию медленный зритель не тормозит.
+class StateBroadcaster {
+public:
+    StateBroadcaster() = default;
+    ~StateBroadcaster();
+    StateBroadcaster(const StateBroadcaster&) = delete;
+    StateBroadcaster& operator=(const StateBroadcaster&) = delete;
+
+    bool listen(const std::string& path);
+    bool isListening() const { return listener >= 0; }
+
+    // Состояние текущего тика заполняет вызывающий, затем publish()
+    StreamState& beginFrame() { return current; }
+    void publish();
+
+    size_t getClientCount() const { return clients.size(); }
+    uint64_t getBytesSent() const { return bytesSent; }
+
+private:
+    struct Client {
+        int fd;
+        bool needsKeyframe;
+    };
+
+    int listener = -1;
+    std::string socketPath;
+    std::vector<Client> clients;
+    StreamState previous;
+    StreamState current;
+    bool hasPrevious = false;
+    uint32_t tick = 0;
+    std::vector<uint8_t> keyframe;
+    std::vector<uint8_t> delta;
+    uint64_t bytesSent = 0;
+
+    void acceptClients();
+    void closeAll();
+};
+
+// Подключение зрителя; кадры читаются без блокировки
+class StateReceiver {
+public:
+    StateReceiver() = default;
+    ~StateReceiver();
+    StateReceiver(const StateReceiver&) = delete;
+    StateReceiver& operator=(const StateReceiver&) = delete;
+
+    bool connect(const std::string& path);
+    bool isConnected() const { return fd >= 0; }
+    void disconnect();
+
+    // Применяет все пришедшие кадры; false - если соединение закрыто
+    bool poll(StreamState& state);
+
+private:
+    int fd = -1;
+    StateDecoder decoder;
+    std::vector<uint8_t> buffer;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Тройной буфер без блокировок для одного писателя и одного читателя.
+// Писатель заполняет back() и публикует его, читатель забирает последний
+// опубликованный буфер в front(). Промежуточные кадры, которые читатель не
+// успел забрать, перезаписываются: читатель всегда видит самый свежий,
+// писатель никогда не ждёт читателя.
+//
+// Три слота: у писателя, у читателя и средний. Публикация и захват - обмен
+// индексом со средним слотом одной атомарной операцией; бит kFresh
+// отмечает, что в среднем слоте лежит ещё не прочитанный кадр.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Только писатель
+    T& back() { return slots[backIndex].value; }
+    void publish() {
+        backIndex = middle.exchange(static_cast<uint8_t>(backIndex | kFresh), std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Только читатель. false - нового кадра нет, front() прежний
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+    const T& front() const { return slots[frontIndex].value; }
+
+private:
+    static const uint8_t kIndexMask = 3;
+    static const uint8_t kFresh = 4;
+
+    // Слоты на разных строках кэша, чтобы писатель и читатель не мешали друг другу
+    struct alignas(64) Slot {
+        T value;
+    };
+    Slot slots[3];
+
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t backIndex = 0;
+    alignas(64) uint8_t frontIndex = 2;
+};
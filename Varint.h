@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Целые переменной длины: без знака - varint (LEB128), со знаком - zigzag +
+// varint. Общие для трансляции состояния (StateStream) и повторов (Replay).
+inline void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+inline void putSigned(std::vector<uint8_t>& out, int64_t value) {
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+// float - битами, чтобы восстановленное состояние совпадало точно
+inline void putFloat(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+}
+
+// Чтение с проверкой границ: любой метод возвращает false, если данных не хватило
+struct ByteReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+
+    bool byte(uint8_t& value) {
+        if (pos >= size) return false;
+        value = data[pos++];
+        return true;
+    }
+
+    template <typename T>
+    bool varint(T& value) {
+        uint64_t raw = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b;
+            if (!byte(b)) return false;
+            raw |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                value = static_cast<T>(raw);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename T>
+    bool signedVarint(T& value) {
+        uint64_t raw;
+        if (!varint(raw)) return false;
+        value = static_cast<T>(static_cast<int64_t>((raw >> 1) ^ (~(raw & 1) + 1)));
+        return true;
+    }
+
+    bool floatValue(float& value) {
+        if (size - pos < 4) return false;
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; ++i) bits |= static_cast<uint32_t>(data[pos++]) << (8 * i);
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool skip(size_t count) {
+        if (size - pos < count) return false;
+        pos += count;
+        return true;
+    }
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// Ключи хэша Зобриста для состояния уровня. Хэш - XOR ключей всех частей
+// состояния (точка в клетке, Пакман в тайле, призрак i в тайле и режиме),
+// поэтому изменение одной части обновляет его двумя XOR: старый ключ
+// убрать, новый добавить. Ключи не хранятся таблицей, а вычисляются
+// смешиванием номера части (splitmix64): размер карты и число призраков
+// не ограничены, а ключи одинаковы на любой машине.
+enum class ZobristKind : uint8_t { PELLET, CELL, PACMAN, GHOST_TILE, GHOST_MODE, GHOST_EATEN };
+
+inline uint64_t zobristKey(ZobristKind kind, uint32_t index, int x, int y, uint8_t value = 0) {
+    uint64_t z = (static_cast<uint64_t>(kind) << 56) ^ (static_cast<uint64_t>(value) << 48) ^
+                 (static_cast<uint64_t>(index) << 32) ^ (static_cast<uint64_t>(static_cast<uint16_t>(y)) << 16) ^
+                 static_cast<uint16_t>(x);
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
@@ -1,10 +1,56 @@
 #include "App.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 int main(int argc, char* argv[]) {
     std::cout << "Starting application..." << std::endl;
     
+    bool latencyProbe = false;
+    bool bot = false;
+    bool headless = false;
+    uint64_t ticks = 0;
+    std::string levelPath = "levels/level1.txt";
+    std::string broadcastPath;
+    float speed = 1.0f;
+    std::string recordPath;
+    std::string replayPath;
+    std::string capturePath;
+    int captureFps = 30;
+    Autopilot::Config botConfig;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--latency") == 0) latencyProbe = true;
+        else if (std::strcmp(argv[i], "--bot") == 0) bot = true;
+        else if (std::strcmp(argv[i], "--headless") == 0) headless = true;
+        else if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) ticks = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--bot-budget") == 0 && hasValue) botConfig.budgetMs = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--level") == 0 && hasValue) levelPath = argv[++i];
+        else if (std::strcmp(argv[i], "--broadcast") == 0 && hasValue) broadcastPath = argv[++i];
+        else if (std::strcmp(argv[i], "--record") == 0 && hasValue) recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--capture") == 0 && hasValue) capturePath = argv[++i];
+        else if (std::strcmp(argv[i], "--capture-fps") == 0 && hasValue) captureFps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--speed") == 0 && hasValue) speed = static_cast<float>(std::atof(argv[++i]));
+        else std::cerr << "Unknown option: " << argv[i] << std::endl;
+    }
+
+    if (!capturePath.empty()) {
+        return App::runCapture(levelPath, ticks, botConfig, capturePath, captureFps);
+    }
+    if (headless) {
+        return App::runHeadless(levelPath, ticks, botConfig, broadcastPath);
+    }
+
     App game;
+    game.setLatencyProbe(latencyProbe);
+    if (bot) game.setAutopilot(botConfig);
+    game.setBroadcastPath(broadcastPath);
+    game.setTimeScale(speed);
+    game.setRecordPath(recordPath);
+    game.setReplayPath(replayPath);
     if (!game.init()) {
         std::cerr << "Failed to initialize game!" << std::endl;
         return 1;